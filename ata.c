@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - ATA (IDE) disk driver
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <io.h>
+#include <pci.h>
+#include <ata.h>
+
+// How many status polls to make before giving up. A port read takes around a microsecond.
+#define ATA_TIMEOUT             10000000
+
+// Largest transfer per command. LBA28 commands are limited to 256 sectors; bigger transfers are capped so the
+// PRD table stays small.
+#define ATA_MAX_SECTORS_LBA28   256
+#define ATA_MAX_SECTORS_LBA48   8192
+#define ATA_MAX_PRDS            ((ATA_MAX_SECTORS_LBA48 << SECTOR_SHIFT) / ATA_PRD_MAX_BYTES + 1)
+
+typedef struct _ata_prd_t
+{
+    uint32_t    addr;
+    uint32_t    count;  // byte count (0 means 64K) | ATA_PRD_EOT
+} ata_prd_t;
+
+typedef struct _ata_drive_t
+{
+    block_device_t  dev;
+    uint16_t        cmd_base;
+    uint16_t        ctrl_base;
+    uint16_t        bm_base;    // 0 if the channel can't do DMA
+    boolean_t       slave;
+    boolean_t       lba48;
+    boolean_t       dma;
+} ata_drive_t;
+
+static ata_drive_t  drives[ATA_MAX_DRIVES];
+static uint32_t     num_drives;
+
+// The PRD table must not cross a 64K boundary
+static ata_prd_t    prd_table[ATA_MAX_PRDS] __attribute__((aligned(1024)));
+
+// Reading the alternate status register 4 times gives the drive the 400ns it needs after a command/select.
+static inline void ata_delay(ata_drive_t *drive)
+{
+    for (int i = 0; i < 4; i++)
+        inb(drive->ctrl_base + ATA_REG_ALTSTATUS);
+}
+
+static boolean_t ata_wait(ata_drive_t *drive, uint8_t mask, uint8_t value, uint8_t *status)
+{
+    for (uint32_t i = 0; i < ATA_TIMEOUT; i++)
+    {
+        uint8_t st = inb(drive->cmd_base + ATA_REG_STATUS);
+
+        if (!(st & ATA_SR_BSY) && (st & (ATA_SR_ERR | ATA_SR_DF)))
+        {
+            if (status)
+                *status = st;
+            return false;
+        }
+
+        if ((st & mask) == value)
+        {
+            if (status)
+                *status = st;
+            return true;
+        }
+    }
+
+    if (status)
+        *status = 0xFF;
+    return false;
+}
+
+static boolean_t ata_issue(ata_drive_t *drive, uint64_t lba, uint32_t count, boolean_t lba48, uint8_t command)
+{
+    if (!ata_wait(drive, ATA_SR_BSY, 0, NULL))
+        return false;
+
+    if (lba48)
+    {
+        outb(drive->cmd_base + ATA_REG_DEVICE, ATA_DEVICE_LBA | (drive->slave ? ATA_DEVICE_SLAVE : 0));
+        ata_delay(drive);
+
+        // High order bytes go first
+        outb(drive->cmd_base + ATA_REG_SECCOUNT, (count >> 8) & 0xFF);
+        outb(drive->cmd_base + ATA_REG_LBA0, (lba >> 24) & 0xFF);
+        outb(drive->cmd_base + ATA_REG_LBA1, (lba >> 32) & 0xFF);
+        outb(drive->cmd_base + ATA_REG_LBA2, (lba >> 40) & 0xFF);
+    }
+    else
+    {
+        outb(drive->cmd_base + ATA_REG_DEVICE,
+             ATA_DEVICE_LBA | (drive->slave ? ATA_DEVICE_SLAVE : 0) | ((lba >> 24) & 0x0F));
+        ata_delay(drive);
+    }
+
+    outb(drive->cmd_base + ATA_REG_SECCOUNT, count & 0xFF);
+    outb(drive->cmd_base + ATA_REG_LBA0, lba & 0xFF);
+    outb(drive->cmd_base + ATA_REG_LBA1, (lba >> 8) & 0xFF);
+    outb(drive->cmd_base + ATA_REG_LBA2, (lba >> 16) & 0xFF);
+    outb(drive->cmd_base + ATA_REG_COMMAND, command);
+    ata_delay(drive);
+
+    return true;
+}
+
+static boolean_t ata_read_pio(ata_drive_t *drive, uint64_t lba, uint32_t count, boolean_t lba48, uint8_t *buf)
+{
+    if (!ata_issue(drive, lba, count, lba48, lba48 ? ATA_CMD_READ_PIO_EXT : ATA_CMD_READ_PIO))
+        return false;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!ata_wait(drive, ATA_SR_BSY | ATA_SR_DRQ, ATA_SR_DRQ, NULL))
+            return false;
+
+        // Each sector goes straight into its final location
+        insw(drive->cmd_base + ATA_REG_DATA, buf, SECTOR_SIZE / 2);
+        buf += SECTOR_SIZE;
+    }
+
+    return true;
+}
+
+static boolean_t ata_read_dma(ata_drive_t *drive, uint64_t lba, uint32_t count, boolean_t lba48, uint8_t *buf)
+{
+    uint32_t    addr = (uint32_t) buf;
+    uint32_t    remaining = count << SECTOR_SHIFT;
+    uint32_t    n = 0;
+
+    // Point the PRDs straight at the destination, splitting at 64K boundaries
+    while (remaining)
+    {
+        uint32_t len = ATA_PRD_MAX_BYTES - (addr & (ATA_PRD_MAX_BYTES - 1));
+        if (len > remaining)
+            len = remaining;
+
+        prd_table[n].addr   = addr;
+        prd_table[n].count  = len & (ATA_PRD_MAX_BYTES - 1);
+        n++;
+
+        addr        += len;
+        remaining   -= len;
+    }
+    prd_table[n - 1].count |= ATA_PRD_EOT;
+
+    outb(drive->bm_base + ATA_BM_COMMAND, 0);
+    outl(drive->bm_base + ATA_BM_PRDT, (uint32_t) prd_table);
+    // Clear the interrupt and error bits
+    outb(drive->bm_base + ATA_BM_STATUS, inb(drive->bm_base + ATA_BM_STATUS) | ATA_BM_SR_IRQ | ATA_BM_SR_ERR);
+
+    if (!ata_issue(drive, lba, count, lba48, lba48 ? ATA_CMD_READ_DMA_EXT : ATA_CMD_READ_DMA))
+        return false;
+
+    outb(drive->bm_base + ATA_BM_COMMAND, ATA_BM_CMD_START | ATA_BM_CMD_READ);
+
+    uint8_t     bm_status;
+    uint32_t    i;
+    for (i = 0; i < ATA_TIMEOUT; i++)
+    {
+        bm_status = inb(drive->bm_base + ATA_BM_STATUS);
+        if ((bm_status & (ATA_BM_SR_IRQ | ATA_BM_SR_ERR)) || !(bm_status & ATA_BM_SR_ACTIVE))
+            break;
+    }
+
+    outb(drive->bm_base + ATA_BM_COMMAND, 0);
+
+    uint8_t status;
+    if (i == ATA_TIMEOUT || (bm_status & ATA_BM_SR_ERR) || !ata_wait(drive, ATA_SR_BSY, 0, &status))
+        return false;
+
+    return !(status & (ATA_SR_ERR | ATA_SR_DF));
+}
+
+static boolean_t ata_read(block_device_t *dev, uint64_t lba, uint32_t count, void *buf)
+{
+    ata_drive_t *drive = dev->priv;
+    uint8_t     *dest = buf;
+
+    while (count)
+    {
+        boolean_t   lba48 = false;
+        uint32_t    chunk = count;
+
+        // Only use LBA48 commands when it saves commands or the address needs it
+        if (drive->lba48 && (chunk > ATA_MAX_SECTORS_LBA28 || lba + chunk > (1 << 28)))
+        {
+            lba48 = true;
+            if (chunk > ATA_MAX_SECTORS_LBA48)
+                chunk = ATA_MAX_SECTORS_LBA48;
+        }
+        else if (chunk > ATA_MAX_SECTORS_LBA28)
+        {
+            chunk = ATA_MAX_SECTORS_LBA28;
+        }
+
+        // The bus master needs an even address
+        boolean_t ok;
+        if (drive->dma && !((uint32_t) dest & 1))
+            ok = ata_read_dma(drive, lba, chunk, lba48, dest);
+        else
+            ok = ata_read_pio(drive, lba, chunk, lba48, dest);
+
+        if (!ok)
+        {
+            err("%s: read of %d sectors at LBA %d failed\n", dev->name, chunk, (uint32_t) lba);
+            return false;
+        }
+
+        lba     += chunk;
+        dest    += chunk << SECTOR_SHIFT;
+        count   -= chunk;
+    }
+
+    return true;
+}
+
+static void ata_identify(uint16_t cmd_base, uint16_t ctrl_base, uint16_t bm_base, boolean_t slave)
+{
+    static uint16_t id[SECTOR_SIZE / 2];
+    ata_drive_t     *drive = &drives[num_drives];
+
+    if (num_drives == ATA_MAX_DRIVES)
+        return;
+
+    memset(drive, 0, sizeof(ata_drive_t));
+    drive->cmd_base     = cmd_base;
+    drive->ctrl_base    = ctrl_base;
+    drive->bm_base      = bm_base;
+    drive->slave        = slave;
+
+    // We poll, so keep the drive from raising interrupts
+    outb(ctrl_base + ATA_REG_DEVCTRL, ATA_DEVCTRL_NIEN);
+
+    outb(cmd_base + ATA_REG_DEVICE, ATA_DEVICE_LBA | (slave ? ATA_DEVICE_SLAVE : 0));
+    ata_delay(drive);
+
+    // Nothing attached to the channel
+    if (inb(cmd_base + ATA_REG_STATUS) == 0xFF)
+        return;
+
+    outb(cmd_base + ATA_REG_SECCOUNT, 0);
+    outb(cmd_base + ATA_REG_LBA0, 0);
+    outb(cmd_base + ATA_REG_LBA1, 0);
+    outb(cmd_base + ATA_REG_LBA2, 0);
+    outb(cmd_base + ATA_REG_COMMAND, ATA_CMD_IDENTIFY);
+    ata_delay(drive);
+
+    if (inb(cmd_base + ATA_REG_STATUS) == 0)
+        return;
+
+    if (!ata_wait(drive, ATA_SR_BSY, 0, NULL))
+        return;
+
+    // ATAPI devices abort IDENTIFY DEVICE and leave their signature behind
+    if (inb(cmd_base + ATA_REG_LBA1) || inb(cmd_base + ATA_REG_LBA2))
+        return;
+
+    if (!ata_wait(drive, ATA_SR_DRQ, ATA_SR_DRQ, NULL))
+        return;
+
+    insw(cmd_base + ATA_REG_DATA, id, SECTOR_SIZE / 2);
+
+    drive->lba48 = (id[ATA_ID_COMMAND_SET_2] & ATA_CMDSET2_LBA48) != 0;
+    if (drive->lba48)
+    {
+        drive->dev.num_sectors = id[ATA_ID_LBA48_SECTORS]
+                                 | ((uint64_t) id[ATA_ID_LBA48_SECTORS + 1] << 16)
+                                 | ((uint64_t) id[ATA_ID_LBA48_SECTORS + 2] << 32)
+                                 | ((uint64_t) id[ATA_ID_LBA48_SECTORS + 3] << 48);
+    }
+    else
+    {
+        drive->dev.num_sectors = id[ATA_ID_LBA28_SECTORS] | ((uint32_t) id[ATA_ID_LBA28_SECTORS + 1] << 16);
+    }
+
+    if (!drive->dev.num_sectors)
+        return;
+
+    // Only use DMA if the firmware already set up an Ultra DMA mode for this drive; we don't program timings.
+    if (bm_base && (id[ATA_ID_CAPABILITIES] & ATA_CAP_DMA) && (id[ATA_ID_UDMA_MODES] & 0x7F00))
+    {
+        uint8_t bm_status = inb(bm_base + ATA_BM_STATUS);
+        drive->dma = (bm_status & (slave ? ATA_BM_SR_DMA_CAPABLE1 : ATA_BM_SR_DMA_CAPABLE0)) != 0;
+    }
+
+    sprintf(drive->dev.name, "ata%d", num_drives);
+    drive->dev.read = ata_read;
+    drive->dev.priv = drive;
+
+    trace("%s: %d sectors%s%s\n", drive->dev.name, (uint32_t) drive->dev.num_sectors,
+          drive->lba48 ? ", LBA48" : "", drive->dma ? ", UDMA" : ", PIO");
+
+    num_drives++;
+}
+
+static void ata_probe_channel(uint16_t cmd_base, uint16_t ctrl_base, uint16_t bm_base)
+{
+    ata_identify(cmd_base, ctrl_base, bm_base, false);
+    ata_identify(cmd_base, ctrl_base, bm_base, true);
+}
+
+// Find all ATA disks on the IDE controllers.
+// Returns the number of disks stored in disks.
+uint32_t ata_probe(block_device_t **disks, uint32_t max_disks)
+{
+    pci_device_t pci;
+
+    num_drives = 0;
+
+    if (pci_find_class(PCI_CLASS_STORAGE_IDE, 0, &pci))
+    {
+        uint16_t bm_base = 0;
+
+        pci_write16(&pci, PCI_COMMAND, pci_read16(&pci, PCI_COMMAND) | PCI_COMMAND_IO | PCI_COMMAND_MASTER);
+
+        // prog_if bit 7: bus master capable
+        if (pci.prog_if & 0x80)
+            bm_base = pci_read32(&pci, PCI_BAR0 + 4 * 4) & PCI_BAR_IO_MASK;
+
+        // prog_if bits 0 and 2: channel runs in native mode and uses the BARs instead of the legacy ports
+        if (pci.prog_if & 0x01)
+            ata_probe_channel(pci_read32(&pci, PCI_BAR0) & PCI_BAR_IO_MASK,
+                              (pci_read32(&pci, PCI_BAR0 + 4) & PCI_BAR_IO_MASK) + 2, bm_base);
+        else
+            ata_probe_channel(ATA_PRIMARY_CMD, ATA_PRIMARY_CTRL, bm_base);
+
+        if (pci.prog_if & 0x04)
+            ata_probe_channel(pci_read32(&pci, PCI_BAR0 + 8) & PCI_BAR_IO_MASK,
+                              (pci_read32(&pci, PCI_BAR0 + 12) & PCI_BAR_IO_MASK) + 2,
+                              bm_base ? bm_base + ATA_BM_SECONDARY : 0);
+        else
+            ata_probe_channel(ATA_SECONDARY_CMD, ATA_SECONDARY_CTRL, bm_base ? bm_base + ATA_BM_SECONDARY : 0);
+    }
+    else
+    {
+        warn("No PCI IDE controller found, trying legacy ports.\n");
+        ata_probe_channel(ATA_PRIMARY_CMD, ATA_PRIMARY_CTRL, 0);
+        ata_probe_channel(ATA_SECONDARY_CMD, ATA_SECONDARY_CTRL, 0);
+    }
+
+    uint32_t n;
+    for (n = 0; n < num_drives && n < max_disks; n++)
+        disks[n] = &drives[n].dev;
+
+    return n;
+}
@@ -7,14 +7,50 @@
 #include <atvlib.h>
 
 #include <linux.h>
+#include <splash.h>
+#include <bli.h>
+
 mach_boot_args_t    *gBA;
 boolean_t           verbose;
 
 extern noreturn void load_linux(void);
 
+// Look for "key=value" in the command line and copy value (NUL terminated) into a buffer of len bytes.
+// Returns false if the key isn't there. Linux ignores options it doesn't know, so loader options can share the line.
+boolean_t cmdline_get(const char *key, char *value, uint32_t len)
+{
+    const char  *p = gBA->cmdline;
+    size_t      key_len = strlen(key);
+
+    while (*p)
+    {
+        while (*p == ' ')
+            p++;
+
+        size_t token_len = strcspn(p, " ");
+
+        if (token_len > key_len && strncmp(p, key, key_len) == 0 && p[key_len] == '=')
+        {
+            size_t value_len = token_len - key_len - 1;
+            if (value_len >= len)
+                value_len = len - 1;
+
+            memcpy(value, p + key_len + 1, value_len);
+            value[value_len] = '\0';
+            return true;
+        }
+
+        p += token_len;
+    }
+
+    return false;
+}
+
 // C entry point for Apple TV code
 noreturn void atvlib_init(mach_boot_args_t *ba)
 {
+    bli_mark_init();
+
     gBA = ba;
 
     // Initialize console.
@@ -27,6 +63,8 @@ noreturn void atvlib_init(mach_boot_args_t *ba)
     verbose = (ba->video.display_mode == DISPLAY_MODE_TEXT);
     if (verbose)
         cons_clear_screen(COLOR_BLACK);
+    else
+        splash_show();
 
     load_linux();
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - Boot Loader Interface EFI variables
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <linux.h>
+#include <cpu.h>
+#include <timer.h>
+#include <bli.h>
+
+static uint64_t init_tsc;
+
+// Remember when the loader started. Call this as early as possible.
+void bli_mark_init(void)
+{
+    init_tsc = rdtsc();
+}
+
+static efi_status_t bli_firmware_set_variable(void *context, uint16_t *name, efi_guid_t *vendor, uint32_t attributes,
+                                              uint32_t data_size, void *data)
+{
+    efi_runtime_services_32_t   *rt = context;
+    efi_set_variable_t          *set_variable = (efi_set_variable_t *) rt->set_variable;
+
+    return set_variable(name, vendor, attributes, data_size, data);
+}
+
+// Check that addr lies in runtime services code at its physical address. After SetVirtualAddressMap() the table
+// holds virtual addresses, which we can't call with paging off unless the mapping was 1:1.
+static boolean_t bli_is_runtime_code(uint32_t addr)
+{
+    uint8_t *desc_ptr = (uint8_t *) gBA->efi_mem_map_ptr;
+    uint8_t *end = desc_ptr + gBA->efi_mem_map_size;
+
+    for (; desc_ptr < end; desc_ptr += gBA->efi_mem_desc_size)
+    {
+        efi_memory_desc_t *desc = (efi_memory_desc_t *) desc_ptr;
+
+        if (desc->type == EFI_RUNTIME_SERVICES_CODE && addr >= desc->phys_addr
+            && addr - desc->phys_addr < (desc->num_pages << EFI_PAGE_SHIFT))
+            return true;
+    }
+
+    return false;
+}
+
+// Publish the loader's timestamps and identity as Boot Loader Interface variables.
+// Call this right before jumping to the kernel.
+void bli_export(efi_system_table_32_t *systbl)
+{
+    char        value[BLI_MAX_VALUE_LEN];
+    bli_info_t  info;
+    bli_ops_t   firmware_ops;
+
+    uint64_t exec_tsc = rdtsc();
+
+    if (!cmdline_get(BLI_CMDLINE_KEY, value, sizeof(value)) || strcmp(value, "1") != 0)
+        return;
+
+    efi_runtime_services_32_t *rt = (efi_runtime_services_32_t *) systbl->runtime;
+
+    if (!rt || rt->hdr.signature != EFI_RUNTIME_SERVICES_SIGNATURE || !bli_is_runtime_code(rt->set_variable))
+    {
+        warn("EFI runtime services aren't callable, not exporting loader variables.\n");
+        return;
+    }
+
+    firmware_ops.set_variable   = bli_firmware_set_variable;
+    firmware_ops.context        = rt;
+
+    // 32 bits of microseconds cover the first 71 minutes after reset, far more than the firmware ever takes
+    info.init_usec      = init_tsc ? (uint32_t) timer_ticks_to_us(init_tsc) : 0;
+    info.exec_usec      = (uint32_t) timer_ticks_to_us(exec_tsc);
+    info.fw_vendor      = (const uint16_t *) systbl->fw_vendor;
+    info.fw_revision    = systbl->fw_revision;
+    info.efi_revision   = systbl->hdr.revision;
+
+    trace("Exporting Boot Loader Interface variables...");
+
+    uint32_t failed = bli_set_variables(&firmware_ops, &info);
+    if (failed)
+    {
+        dprintf("%d of them failed.\n", failed);
+    }
+    else
+    {
+        dprintf("done.\n");
+    }
+}
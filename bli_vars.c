@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - Boot Loader Interface variable encoding
+ * SPDX-License-Identifier: MIT
+ */
+
+// Everything here only formats values and hands them to bli_ops_t, so it also builds on the host for
+// tests/bli_test.c (with BLI_HOST_TEST defined).
+#ifdef BLI_HOST_TEST
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#else
+#include <atvlib.h>
+#endif
+
+#include <efi.h>
+#include <bli.h>
+
+// Widen an ASCII string into at most BLI_MAX_VALUE_LEN UTF-16 characters. Returns the size in bytes including the NUL.
+static uint32_t bli_to_utf16(uint16_t *dst, const char *src)
+{
+    uint32_t i;
+
+    for (i = 0; i < BLI_MAX_VALUE_LEN - 1 && src[i]; i++)
+        dst[i] = (uint8_t) src[i];
+    dst[i] = 0;
+
+    return (i + 1) * sizeof(uint16_t);
+}
+
+// Narrow a UTF-16 string from the firmware, replacing anything outside ASCII
+static void bli_from_utf16(char *dst, const uint16_t *src, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len - 1 && src && src[i]; i++)
+        dst[i] = (src[i] < 0x80) ? (char) src[i] : '?';
+    dst[i] = 0;
+}
+
+// Set one variable to an ASCII value, stored as NUL-terminated UTF-16. Returns 1 on success, 0 on failure.
+static uint32_t bli_set_string(const bli_ops_t *ops, const char *name, const char *value)
+{
+    uint16_t    name16[BLI_MAX_VALUE_LEN];
+    uint16_t    value16[BLI_MAX_VALUE_LEN];
+    efi_guid_t  vendor = LOADER_VARIABLE_GUID;
+
+    bli_to_utf16(name16, name);
+    uint32_t size = bli_to_utf16(value16, value);
+
+    return ops->set_variable(ops->context, name16, &vendor, LOADER_VARIABLE_ATTRIBUTES, size, value16) == EFI_SUCCESS;
+}
+
+// Set all Boot Loader Interface variables the loader knows about. Returns how many of them failed.
+uint32_t bli_set_variables(const bli_ops_t *ops, const bli_info_t *info)
+{
+    char        value[BLI_MAX_VALUE_LEN];
+    char        vendor[BLI_MAX_VALUE_LEN - 16];
+    uint32_t    failed = 0;
+
+    if (info->init_usec)
+    {
+        sprintf(value, "%u", info->init_usec);
+        failed += !bli_set_string(ops, "LoaderTimeInitUSec", value);
+    }
+
+    sprintf(value, "%u", info->exec_usec);
+    failed += !bli_set_string(ops, "LoaderTimeExecUSec", value);
+
+    failed += !bli_set_string(ops, "LoaderInfo", LOADER_INFO);
+
+    bli_from_utf16(vendor, info->fw_vendor, sizeof(vendor));
+    sprintf(value, "%s %d.%02d", vendor[0] ? vendor : "Unknown", info->fw_revision >> 16, info->fw_revision & 0xFFFF);
+    failed += !bli_set_string(ops, "LoaderFirmwareInfo", value);
+
+    // Apple's firmware implements EFI 1.10, which predates the "UEFI" name
+    sprintf(value, "%s %d.%02d", (info->efi_revision >> 16) >= 2 ? "UEFI" : "EFI", info->efi_revision >> 16,
+            info->efi_revision & 0xFFFF);
+    failed += !bli_set_string(ops, "LoaderFirmwareType", value);
+
+    return failed;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - block device layer and partition tables
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <blockdev.h>
+
+#define GPT_HEADER_LBA          1
+#define GPT_SIGNATURE           "EFI PART"
+#define GPT_NAME_LEN            36
+
+#define MBR_SIGNATURE           0xAA55
+#define MBR_TYPE_GPT_PROTECTIVE 0xEE
+
+typedef struct _gpt_header_t
+{
+    char        signature[8];
+    uint32_t    revision;
+    uint32_t    header_size;
+    uint32_t    header_crc32;
+    uint32_t    reserved;
+    uint64_t    current_lba;
+    uint64_t    backup_lba;
+    uint64_t    first_usable_lba;
+    uint64_t    last_usable_lba;
+    uint8_t     disk_guid[16];
+    uint64_t    entries_lba;
+    uint32_t    num_entries;
+    uint32_t    entry_size;
+    uint32_t    entries_crc32;
+} __attribute__((packed)) gpt_header_t;
+
+typedef struct _gpt_entry_t
+{
+    uint8_t     type_guid[16];
+    uint8_t     unique_guid[16];
+    uint64_t    first_lba;
+    uint64_t    last_lba;
+    uint64_t    attributes;
+    uint16_t    name[GPT_NAME_LEN];
+} __attribute__((packed)) gpt_entry_t;
+
+typedef struct _mbr_entry_t
+{
+    uint8_t     status;
+    uint8_t     chs_first[3];
+    uint8_t     type;
+    uint8_t     chs_last[3];
+    uint32_t    first_lba;
+    uint32_t    num_sectors;
+} __attribute__((packed)) mbr_entry_t;
+
+typedef struct _mbr_t
+{
+    uint8_t     boot_code[446];
+    mbr_entry_t entries[4];
+    uint16_t    signature;
+} __attribute__((packed)) mbr_t;
+
+// One partition found on a disk
+typedef struct _partition_info_t
+{
+    uint64_t    first_lba;
+    uint64_t    num_sectors;
+    char        label[GPT_NAME_LEN + 1];
+} partition_info_t;
+
+static uint8_t sector_buf[SECTOR_SIZE] __attribute__((aligned(16)));
+
+// Partition table of the disk scanned last. Callers walk the partitions with increasing indices, so the disk is only
+// read again when asked for index 0 or for a different disk.
+static block_device_t   *table_disk;
+static partition_info_t table[BLOCKDEV_MAX_PARTITIONS];
+static uint32_t         table_len;
+
+boolean_t blockdev_read(block_device_t *dev, uint64_t lba, uint32_t count, void *buf)
+{
+    if (lba + count > dev->num_sectors)
+        return false;
+
+    return dev->read(dev, dev->offset + lba, count, buf);
+}
+
+static void blockdev_make_partition(block_device_t *disk, block_device_t *part, uint64_t first, uint64_t count)
+{
+    *part = *disk;
+    part->offset        = disk->offset + first;
+    part->num_sectors   = count;
+}
+
+static void gpt_scan(block_device_t *disk)
+{
+    gpt_header_t    header;
+    gpt_entry_t     entry;
+
+    if (!blockdev_read(disk, GPT_HEADER_LBA, 1, sector_buf))
+        return;
+
+    // Entries are walked a sector at a time, so they must not straddle sector boundaries
+    memcpy(&header, sector_buf, sizeof(header));
+    if (memcmp(header.signature, GPT_SIGNATURE, sizeof(header.signature)) != 0
+        || header.entry_size < sizeof(gpt_entry_t) || header.entry_size > SECTOR_SIZE
+        || (header.entry_size & (header.entry_size - 1)))
+        return;
+
+    uint32_t entries_per_sector = SECTOR_SIZE / header.entry_size;
+
+    for (uint32_t i = 0; i < header.num_entries; i++)
+    {
+        uint32_t slot = i & (entries_per_sector - 1);
+
+        if (!slot && !blockdev_read(disk, header.entries_lba + i / entries_per_sector, 1, sector_buf))
+            return;
+
+        memcpy(&entry, sector_buf + slot * header.entry_size, sizeof(entry));
+
+        // Unused entries have a zero type GUID
+        uint8_t used = 0;
+        for (int b = 0; b < sizeof(entry.type_guid); b++)
+            used |= entry.type_guid[b];
+
+        if (!used || entry.last_lba < entry.first_lba)
+            continue;
+
+        if (table_len == BLOCKDEV_MAX_PARTITIONS)
+        {
+            warn("%s has too many partitions, ignoring the rest.\n", disk->name);
+            return;
+        }
+
+        partition_info_t *info = &table[table_len++];
+        info->first_lba     = entry.first_lba;
+        info->num_sectors   = entry.last_lba - entry.first_lba + 1;
+
+        // Partition names are UTF-16; anything outside ASCII becomes '?'
+        uint32_t c;
+        for (c = 0; c < GPT_NAME_LEN && entry.name[c]; c++)
+            info->label[c] = (entry.name[c] < 0x80) ? (char) entry.name[c] : '?';
+        info->label[c] = '\0';
+    }
+}
+
+// Read the partition table of a disk, looking at the GPT first and the MBR after.
+static void blockdev_scan(block_device_t *disk)
+{
+    mbr_t *mbr = (mbr_t *) sector_buf;
+
+    table_disk  = disk;
+    table_len   = 0;
+
+    if (!blockdev_read(disk, 0, 1, sector_buf))
+        return;
+
+    if (mbr->signature != MBR_SIGNATURE)
+        return;
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (mbr->entries[i].type == MBR_TYPE_GPT_PROTECTIVE)
+        {
+            gpt_scan(disk);
+            return;
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        mbr_entry_t *entry = &mbr->entries[i];
+
+        if (!entry->type || !entry->num_sectors)
+            continue;
+
+        table[table_len].first_lba      = entry->first_lba;
+        table[table_len].num_sectors    = entry->num_sectors;
+        table[table_len].label[0]       = '\0';
+        table_len++;
+    }
+}
+
+// Find the index'th partition on a disk, looking at the GPT first and the MBR after.
+// label receives the GPT partition name, or an empty string.
+boolean_t blockdev_partition(block_device_t *disk, uint32_t index, block_device_t *part, char *label,
+                             uint32_t label_len)
+{
+    if (!index || disk != table_disk)
+        blockdev_scan(disk);
+
+    if (index >= table_len)
+        return false;
+
+    blockdev_make_partition(disk, part, table[index].first_lba, table[index].num_sectors);
+    if (label_len)
+        strlcpy(label, table[index].label, label_len);
+
+    return true;
+}
@@ -6,6 +6,7 @@
 
 #include <atvlib.h>
 #include <font.h>
+#include <gfx.h>
 
 linear_framebuffer_t    fb;
 static console_priv_t   con;
@@ -55,11 +56,9 @@ void cons_print_char(void *p, char c)
     // Scroll down (this function is very slow)
     if (con.cursor_y >= con.height)
     {
-        uint32_t    top = (fb.pitch * ISO_CHAR_HEIGHT);
-
         // We should double buffer here. But we don't. Who cares.
-        memmove((void *) fb.base, (const void *) fb.base + top, fb.size - top);
-        memset((void *) fb.base + fb.size - top, 0, top);
+        gfx_copy_rows(0, ISO_CHAR_HEIGHT, fb.height - ISO_CHAR_HEIGHT);
+        gfx_fill_rect(0, fb.height - ISO_CHAR_HEIGHT, fb.width, ISO_CHAR_HEIGHT, con.bg_color);
         con.cursor_y--;
     }
 
@@ -96,16 +95,7 @@ boolean_t cons_clear_screen(uint32_t color)
     if (!fb.enabled)
         return false;
 
-    uint32_t    native_color = RGBA_TO_NATIVE(fb, color);
-
-    for (uint32_t line = 0; line < fb.height; line++)
-    {
-        uint32_t *screen = (uint32_t *) ((char *) fb.base + line * fb.pitch);
-        for (uint32_t column = 0; column < fb.width; column++)
-        {
-            *screen++ = native_color;
-        }
-    }
+    gfx_fill_rect(0, 0, fb.width, fb.height, RGBA_TO_NATIVE(fb, color));
 
     con.cursor_x = 0;
     con.cursor_y = 0;
@@ -181,5 +171,8 @@ boolean_t cons_init(void *video_params, uint32_t fg_color, uint32_t bg_color)
 
     fb.enabled = true;
 
+    // set up 2D primitives
+    gfx_init();
+
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - cpio (newc) archive support
+ * SPDX-License-Identifier: MIT
+ */
+
+// Nothing here touches hardware, so it also builds on the host for tests/prune_test.c (with CPIO_HOST_TEST defined).
+#ifdef CPIO_HOST_TEST
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef _Bool boolean_t;
+#define true                1
+#define false               0
+
+#define warn(fmt, ...)      fprintf(stderr, fmt, ##__VA_ARGS__)
+#else
+#include <atvlib.h>
+#endif
+
+#include <cpio.h>
+
+#define CPIO_ALIGN(x)   (((x) + 3) & ~3)
+
+// Parse one 8 digit hex field
+static boolean_t cpio_hex(const char *field, uint32_t *value)
+{
+    *value = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        char c = field[i];
+
+        if (c >= '0' && c <= '9')
+            *value = (*value << 4) | (c - '0');
+        else if (c >= 'a' && c <= 'f')
+            *value = (*value << 4) | (c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            *value = (*value << 4) | (c - 'A' + 10);
+        else
+            return false;
+    }
+
+    return true;
+}
+
+// Match an entry name against a pattern of len characters, where '*' matches any run of characters and '?' any single
+// one. A match of the whole pattern on a path component boundary also covers everything below it.
+boolean_t cpio_match(const char *pattern, uint32_t len, const char *name)
+{
+    while (len)
+    {
+        if (*pattern == '*')
+        {
+            // Try every possible length for the star, shortest first
+            for (const char *s = name; ; s++)
+            {
+                if (cpio_match(pattern + 1, len - 1, s))
+                    return true;
+                if (!*s)
+                    return false;
+            }
+        }
+
+        if (!*name || (*pattern != '?' && *pattern != *name))
+            return false;
+
+        pattern++;
+        name++;
+        len--;
+    }
+
+    return *name == 0 || *name == '/';
+}
+
+// Copy the archive(s) at src to dst, leaving out the entries drop() picks, and return the new length.
+// This is a single pass: kept entries are moved as they are found, so dst may be src itself, anywhere below it or a
+// separate buffer, but must not overlap the archive from above.
+// Anything that isn't a newc archive (e.g. a compressed archive concatenated behind it) ends the walk and is copied
+// as-is.
+uint32_t cpio_prune(void *dst, const void *src, uint32_t len, cpio_filter_t drop, void *context,
+                    cpio_prune_stats_t *stats)
+{
+    const uint8_t   *in     = src;
+    const uint8_t   *end    = in + len;
+    uint8_t         *out    = dst;
+
+    memset(stats, 0, sizeof(cpio_prune_stats_t));
+
+    while (in < end)
+    {
+        // Padding between archives; keep it so every archive stays 4 byte aligned
+        if (*in == 0)
+        {
+            const uint8_t *pad = in;
+            while (in < end && *in == 0)
+                in++;
+
+            memmove(out, pad, in - pad);
+            out += in - pad;
+            continue;
+        }
+
+        const cpio_newc_header_t *header = (const cpio_newc_header_t *) in;
+        uint32_t mode, nlink, filesize, namesize;
+
+        if (end - in < CPIO_HEADER_SIZE
+            || (memcmp(header->magic, CPIO_NEWC_MAGIC, CPIO_MAGIC_LEN) != 0
+                && memcmp(header->magic, CPIO_NEWC_CRC_MAGIC, CPIO_MAGIC_LEN) != 0)
+            || !cpio_hex(header->mode, &mode) || !cpio_hex(header->nlink, &nlink)
+            || !cpio_hex(header->filesize, &filesize) || !cpio_hex(header->namesize, &namesize))
+        {
+            if (in == src)
+            {
+                warn("Initramfs isn't an uncompressed cpio archive, not pruning it.\n");
+            }
+            else
+            {
+                warn("Unknown data at offset 0x%X of the initramfs, copying the rest as-is.\n",
+                     (uint32_t) (in - (const uint8_t *) src));
+            }
+            break;
+        }
+
+        const char  *name       = (const char *) in + CPIO_HEADER_SIZE;
+        uint32_t    remaining   = end - in;
+        uint32_t    data_offset = CPIO_ALIGN(CPIO_HEADER_SIZE + namesize);
+
+        if (!namesize || namesize > remaining - CPIO_HEADER_SIZE || name[namesize - 1] != 0
+            || (filesize && (data_offset > remaining || filesize > remaining - data_offset)))
+        {
+            warn("Malformed cpio entry at offset 0x%X of the initramfs, copying the rest as-is.\n",
+                 (uint32_t) (in - (const uint8_t *) src));
+            break;
+        }
+
+        // The padding of the last entry may be cut off
+        uint32_t entry_len = data_offset + CPIO_ALIGN(filesize);
+        if (entry_len > remaining)
+            entry_len = remaining;
+
+        while (*name == '.' && name[1] == '/')
+            name += 2;
+        while (*name == '/')
+            name++;
+
+        // newc stores the data of hard linked files with the last link only, so dropping a link could take the data
+        // of the others with it.
+        boolean_t hardlink = (mode & CPIO_MODE_TYPE_MASK) == CPIO_MODE_REGULAR && nlink > 1;
+
+        if (strcmp(name, CPIO_TRAILER) != 0 && *name && !hardlink && drop(name, mode, context))
+        {
+            stats->dropped++;
+            stats->dropped_bytes += entry_len;
+        }
+        else
+        {
+            if (out != in)
+                memmove(out, in, entry_len);
+            out += entry_len;
+            stats->kept++;
+        }
+
+        in += entry_len;
+    }
+
+    if (in < end)
+    {
+        if (out != in)
+            memmove(out, in, end - in);
+        out += end - in;
+    }
+
+    return out - (uint8_t *) dst;
+}
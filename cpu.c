@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: x86 CPU helpers
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <cpu.h>
+
+// Turn on SSE/SSE2 if the CPU has it. boot.efi doesn't promise to leave it enabled, and Linux sets up CR0/CR4 itself
+// anyway. Returns false if SSE2 can't be used.
+boolean_t cpu_enable_sse2(void)
+{
+    static int  state = -1;
+    uint32_t    eax, ebx, ecx, edx;
+
+    if (state >= 0)
+        return state;
+
+    cpuid(CPUID_FEATURES, &eax, &ebx, &ecx, &edx);
+
+    if ((edx & (CPUID_EDX_FXSR | CPUID_EDX_SSE | CPUID_EDX_SSE2)) != (CPUID_EDX_FXSR | CPUID_EDX_SSE | CPUID_EDX_SSE2))
+    {
+        state = false;
+        return false;
+    }
+
+    write_cr0((read_cr0() & ~CR0_EM) | CR0_MP);
+    write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+
+    state = true;
+    return true;
+}
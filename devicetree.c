@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - XNU flattened device tree support
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <linux.h>
+#include <devicetree.h>
+
+#define DT_PROPERTY_LENGTH_MASK 0x7FFFFFFF
+#define DT_ALIGN(len)           (((len) + 3) & ~3)
+
+static inline uint8_t *dt_end(void)
+{
+    return (uint8_t *) (gBA->device_tree_ptr + gBA->device_tree_len);
+}
+
+static inline uint8_t *dt_property_value(dt_property_t *prop)
+{
+    return (uint8_t *) (prop + 1);
+}
+
+static inline dt_property_t *dt_property_after(dt_property_t *prop)
+{
+    return (dt_property_t *) (dt_property_value(prop) + DT_ALIGN(prop->length & DT_PROPERTY_LENGTH_MASK));
+}
+
+// Return the first byte after the node and all of its children, or NULL if the tree is malformed.
+static dt_node_t *dt_node_after(dt_node_t *node)
+{
+    dt_property_t *prop = (dt_property_t *) (node + 1);
+
+    for (uint32_t i = 0; i < node->num_properties; i++)
+    {
+        if ((uint8_t *) (prop + 1) > dt_end())
+            return NULL;
+        prop = dt_property_after(prop);
+    }
+
+    dt_node_t *child = (dt_node_t *) prop;
+
+    for (uint32_t i = 0; i < node->num_children; i++)
+    {
+        if ((uint8_t *) (child + 1) > dt_end() || !(child = dt_node_after(child)))
+            return NULL;
+    }
+
+    if ((uint8_t *) child > dt_end())
+        return NULL;
+
+    return child;
+}
+
+dt_node_t *dt_root(void)
+{
+    if (!gBA->device_tree_ptr || gBA->device_tree_len < sizeof(dt_node_t))
+        return NULL;
+
+    return (dt_node_t *) gBA->device_tree_ptr;
+}
+
+// Return the property after prev, or the first property if prev is NULL.
+dt_property_t *dt_next_property(dt_node_t *node, dt_property_t *prev)
+{
+    dt_property_t   *prop = (dt_property_t *) (node + 1);
+    uint32_t        i = 0;
+
+    if (prev)
+    {
+        while (prop != prev && i < node->num_properties)
+        {
+            prop = dt_property_after(prop);
+            i++;
+        }
+        prop = dt_property_after(prop);
+        i++;
+    }
+
+    if (i >= node->num_properties || (uint8_t *) (prop + 1) > dt_end())
+        return NULL;
+
+    return prop;
+}
+
+void *dt_get_property(dt_node_t *node, const char *name, uint32_t *length)
+{
+    for (dt_property_t *prop = dt_next_property(node, NULL); prop; prop = dt_next_property(node, prop))
+    {
+        if (strncmp(prop->name, name, DT_PROPERTY_NAME_LENGTH) == 0)
+        {
+            if (length)
+                *length = prop->length & DT_PROPERTY_LENGTH_MASK;
+            return dt_property_value(prop);
+        }
+    }
+
+    return NULL;
+}
+
+// Look up a node by its path, e.g. "/chosen/memory-map".
+dt_node_t *dt_find_node(const char *path)
+{
+    dt_node_t *node = dt_root();
+
+    while (node && *path)
+    {
+        while (*path == '/')
+            path++;
+        if (!*path)
+            break;
+
+        size_t component_len = strcspn(path, "/");
+
+        // Children start right after the last property
+        dt_property_t   *prop = dt_next_property(node, NULL);
+        dt_node_t       *child = (dt_node_t *) (node + 1);
+        while (prop)
+        {
+            child = (dt_node_t *) dt_property_after(prop);
+            prop = dt_next_property(node, prop);
+        }
+
+        dt_node_t *found = NULL;
+        for (uint32_t i = 0; i < node->num_children && child; i++)
+        {
+            uint32_t    name_len;
+            char        *name = dt_get_property(child, "name", &name_len);
+
+            // The name property includes the NUL terminator
+            if (name && strnlen(name, name_len) == component_len && strncmp(name, path, component_len) == 0)
+            {
+                found = child;
+                break;
+            }
+
+            child = dt_node_after(child);
+        }
+
+        node = found;
+        path += component_len;
+    }
+
+    return node;
+}
+
+// Find the <string> value following <key>key</key> in an XML plist of len bytes. Returns NULL if there is none.
+static const char *dt_plist_string(const char *plist, uint32_t len, const char *key, uint32_t *value_len)
+{
+    char        key_tag[64];
+    const char  *end = plist + len;
+
+    strlcpy(key_tag, "<key>", sizeof(key_tag));
+    strlcat(key_tag, key, sizeof(key_tag));
+    strlcat(key_tag, "</key>", sizeof(key_tag));
+
+    const char *p = memmem(plist, len, key_tag, strlen(key_tag));
+    if (!p)
+        return NULL;
+
+    p += strlen(key_tag);
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        p++;
+
+    if (end - p < sizeof("<string>") - 1 || strncmp(p, "<string>", sizeof("<string>") - 1) != 0)
+        return NULL;
+    p += sizeof("<string>") - 1;
+
+    const char *value_end = memchr(p, '<', end - p);
+    if (!value_end)
+        return NULL;
+
+    *value_len = value_end - p;
+    return p;
+}
+
+// Find an extension loaded by boot.efi by its CFBundleIdentifier and return its executable in place.
+const uint8_t *dt_find_extension(const char *bundle_id, uint32_t *length)
+{
+    dt_node_t *memory_map = dt_find_node("/chosen/memory-map");
+    if (!memory_map)
+        return NULL;
+
+    size_t bundle_id_len = strlen(bundle_id);
+
+    for (dt_property_t *prop = dt_next_property(memory_map, NULL); prop; prop = dt_next_property(memory_map, prop))
+    {
+        if (strncmp(prop->name, DT_DRIVER_PREFIX, sizeof(DT_DRIVER_PREFIX) - 1) != 0
+            || (prop->length & DT_PROPERTY_LENGTH_MASK) < sizeof(dt_memory_range_t))
+            continue;
+
+        dt_memory_range_t       *range = (dt_memory_range_t *) dt_property_value(prop);
+        booter_kext_file_info_t *info = (booter_kext_file_info_t *) range->paddr;
+
+        if (range->length < sizeof(booter_kext_file_info_t) || !info->info_dict_paddr || !info->info_dict_length)
+            continue;
+
+        uint32_t    id_len;
+        const char  *id = dt_plist_string((const char *) info->info_dict_paddr, info->info_dict_length,
+                                          "CFBundleIdentifier", &id_len);
+
+        if (!id || id_len != bundle_id_len || strncmp(id, bundle_id, bundle_id_len) != 0)
+            continue;
+
+        if (!info->executable_paddr || !info->executable_length)
+        {
+            warn("Extension %s has no executable!\n", bundle_id);
+            continue;
+        }
+
+        *length = info->executable_length;
+        return (const uint8_t *) info->executable_paddr;
+    }
+
+    return NULL;
+}
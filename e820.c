@@ -90,4 +90,58 @@ uint8_t efi_to_e820_map(efi_memory_desc_t *efi_map,
     }
 
     return bios_num_entries;
-}
\ No newline at end of file
+}
+
+// Change the type of [addr, addr + size) wherever it overlaps an entry of type from, splitting entries as needed.
+// Returns false if the table has no room for the split.
+boolean_t e820_change_type(struct boot_e820_entry *memory_map,
+                           uint8_t *num_entries,
+                           uint64_t addr,
+                           uint64_t size,
+                           uint32_t from,
+                           uint32_t to)
+{
+    uint64_t end = addr + size;
+
+    for (uint32_t i = 0; i < *num_entries; i++)
+    {
+        struct boot_e820_entry  entry = memory_map[i];
+        uint64_t                entry_end = entry.addr + entry.size;
+
+        if (entry.type != from || entry_end <= addr || entry.addr >= end)
+            continue;
+
+        uint64_t mid_start  = (entry.addr > addr) ? entry.addr : addr;
+        uint64_t mid_end    = (entry_end < end) ? entry_end : end;
+        uint32_t pieces     = 1 + (mid_start > entry.addr) + (mid_end < entry_end);
+
+        if (*num_entries + pieces - 1 > E820_MAX_ENTRIES_ZEROPAGE)
+            return false;
+
+        // Make room for the extra pieces
+        memmove(&memory_map[i + pieces], &memory_map[i + 1], (*num_entries - i - 1) * sizeof(struct boot_e820_entry));
+        *num_entries += pieces - 1;
+
+        if (mid_start > entry.addr)
+        {
+            memory_map[i].addr  = entry.addr;
+            memory_map[i].size  = mid_start - entry.addr;
+            memory_map[i].type  = from;
+            i++;
+        }
+
+        memory_map[i].addr  = mid_start;
+        memory_map[i].size  = mid_end - mid_start;
+        memory_map[i].type  = to;
+
+        if (mid_end < entry_end)
+        {
+            i++;
+            memory_map[i].addr  = mid_end;
+            memory_map[i].size  = entry_end - mid_end;
+            memory_map[i].type  = from;
+        }
+    }
+
+    return true;
+}
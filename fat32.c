@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - read-only FAT32 support
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <fat32.h>
+
+#define FAT32_FIRST_CLUSTER     2
+#define FAT_ENTRIES_PER_SECTOR  (SECTOR_SIZE / sizeof(uint32_t))
+#define DIRENTS_PER_SECTOR      (SECTOR_SIZE / sizeof(fat_dirent_t))
+
+static uint8_t  sector_buf[SECTOR_SIZE] __attribute__((aligned(16)));
+static uint32_t fat_cache[FAT_ENTRIES_PER_SECTOR];
+static uint32_t fat_cache_sector;
+static block_device_t *fat_cache_dev;
+
+static inline boolean_t fat32_valid_cluster(fat32_volume_t *volume, uint32_t cluster)
+{
+    return cluster >= FAT32_FIRST_CLUSTER && cluster < volume->num_clusters + FAT32_FIRST_CLUSTER;
+}
+
+static inline uint32_t fat32_cluster_to_sector(fat32_volume_t *volume, uint32_t cluster)
+{
+    return volume->data_start + ((cluster - FAT32_FIRST_CLUSTER) << volume->cluster_shift);
+}
+
+// Look up the cluster after this one in the FAT. Returns 0 on error.
+static uint32_t fat32_next_cluster(fat32_volume_t *volume, uint32_t cluster)
+{
+    uint32_t sector = volume->fat_start + cluster / FAT_ENTRIES_PER_SECTOR;
+
+    if (fat_cache_dev != volume->dev || fat_cache_sector != sector)
+    {
+        if (!blockdev_read(volume->dev, sector, 1, fat_cache))
+        {
+            fat_cache_dev = NULL;
+            return 0;
+        }
+        fat_cache_dev       = volume->dev;
+        fat_cache_sector    = sector;
+    }
+
+    return fat_cache[cluster % FAT_ENTRIES_PER_SECTOR] & FAT32_CLUSTER_MASK;
+}
+
+boolean_t fat32_mount(block_device_t *dev, fat32_volume_t *volume)
+{
+    fat32_bpb_t *bpb = (fat32_bpb_t *) sector_buf;
+
+    // The cache is keyed on the device, and callers may reuse one block_device_t for several partitions
+    fat_cache_dev = NULL;
+
+    if (!blockdev_read(dev, 0, 1, sector_buf))
+        return false;
+
+    if (sector_buf[510] != 0x55 || sector_buf[511] != 0xAA)
+        return false;
+
+    // FAT12/16 have a fixed root directory and a 16-bit FAT size
+    if (bpb->bytes_per_sector != SECTOR_SIZE || !bpb->sectors_per_cluster
+        || (bpb->sectors_per_cluster & (bpb->sectors_per_cluster - 1))
+        || bpb->root_entries || bpb->fat_size_16 || !bpb->fat_size_32 || !bpb->num_fats)
+        return false;
+
+    memset(volume, 0, sizeof(fat32_volume_t));
+    volume->dev                 = dev;
+    volume->sectors_per_cluster = bpb->sectors_per_cluster;
+    while ((1 << volume->cluster_shift) < volume->sectors_per_cluster)
+        volume->cluster_shift++;
+
+    uint32_t total_sectors  = bpb->total_sectors_32 ? bpb->total_sectors_32 : bpb->total_sectors_16;
+    volume->fat_start       = bpb->reserved_sectors;
+    volume->data_start      = bpb->reserved_sectors + bpb->num_fats * bpb->fat_size_32;
+    volume->root_cluster    = bpb->root_cluster;
+
+    if (total_sectors <= volume->data_start || total_sectors > dev->num_sectors)
+        return false;
+
+    volume->num_clusters = (total_sectors - volume->data_start) >> volume->cluster_shift;
+
+    memcpy(volume->label, bpb->volume_label, sizeof(bpb->volume_label));
+    for (int i = sizeof(bpb->volume_label) - 1; i >= 0 && volume->label[i] == ' '; i--)
+        volume->label[i] = '\0';
+
+    return fat32_valid_cluster(volume, volume->root_cluster);
+}
+
+// Convert "name.ext" to the space padded, upper case 8.3 form used in directory entries.
+static boolean_t fat32_short_name(const char *name, char *short_name)
+{
+    int i = 0;
+
+    memset(short_name, ' ', 11);
+
+    for (; *name && *name != '.'; name++)
+    {
+        if (i == 8)
+            return false;
+        short_name[i++] = (*name >= 'a' && *name <= 'z') ? *name - 'a' + 'A' : *name;
+    }
+
+    if (*name == '.')
+        name++;
+
+    for (i = 8; *name; name++)
+    {
+        if (i == 11 || *name == '.')
+            return false;
+        short_name[i++] = (*name >= 'a' && *name <= 'z') ? *name - 'a' + 'A' : *name;
+    }
+
+    return true;
+}
+
+// Look up a file in the root directory. Only 8.3 names are supported.
+boolean_t fat32_open(fat32_volume_t *volume, const char *name, fat32_file_t *file)
+{
+    char        short_name[11];
+    uint32_t    cluster = volume->root_cluster;
+
+    if (!fat32_short_name(name, short_name))
+        return false;
+
+    while (fat32_valid_cluster(volume, cluster))
+    {
+        uint32_t sector = fat32_cluster_to_sector(volume, cluster);
+
+        for (uint32_t s = 0; s < volume->sectors_per_cluster; s++)
+        {
+            if (!blockdev_read(volume->dev, sector + s, 1, sector_buf))
+                return false;
+
+            fat_dirent_t *dirent = (fat_dirent_t *) sector_buf;
+            for (uint32_t i = 0; i < DIRENTS_PER_SECTOR; i++, dirent++)
+            {
+                if ((uint8_t) dirent->name[0] == FAT_DIRENT_END)
+                    return false;
+
+                if ((uint8_t) dirent->name[0] == FAT_DIRENT_FREE || dirent->attr == FAT_ATTR_LFN
+                    || (dirent->attr & (FAT_ATTR_VOLUME_ID | FAT_ATTR_DIRECTORY)))
+                    continue;
+
+                if (memcmp(dirent->name, short_name, sizeof(short_name)) == 0)
+                {
+                    file->volume        = volume;
+                    file->first_cluster = ((uint32_t) dirent->cluster_high << 16) | dirent->cluster_low;
+                    file->size          = dirent->size;
+                    return true;
+                }
+            }
+        }
+
+        cluster = fat32_next_cluster(volume, cluster);
+    }
+
+    return false;
+}
+
+// Read a whole file into buf. Runs of contiguous clusters are read with one request straight into buf; only a
+// trailing partial sector goes through a bounce buffer.
+boolean_t fat32_read(fat32_file_t *file, void *buf)
+{
+    fat32_volume_t  *volume = file->volume;
+    uint8_t         *dest = buf;
+    uint32_t        remaining = file->size;
+    uint32_t        cluster = file->first_cluster;
+
+    while (remaining)
+    {
+        if (!fat32_valid_cluster(volume, cluster))
+        {
+            err("FAT32: bad cluster chain\n");
+            return false;
+        }
+
+        // Extend the run as long as the chain stays contiguous and there's data left
+        uint32_t run_start      = cluster;
+        uint32_t run_clusters   = 1;
+        uint32_t cluster_bytes  = SECTOR_SIZE << volume->cluster_shift;
+
+        while ((run_clusters * cluster_bytes) < remaining)
+        {
+            uint32_t next = fat32_next_cluster(volume, cluster);
+            if (next != cluster + 1)
+            {
+                cluster = next;
+                break;
+            }
+            cluster = next;
+            run_clusters++;
+        }
+
+        uint32_t run_bytes = run_clusters * cluster_bytes;
+        if (run_bytes > remaining)
+            run_bytes = remaining;
+
+        uint32_t sector         = fat32_cluster_to_sector(volume, run_start);
+        uint32_t full_sectors   = run_bytes >> SECTOR_SHIFT;
+
+        if (full_sectors && !blockdev_read(volume->dev, sector, full_sectors, dest))
+            return false;
+
+        if (run_bytes & (SECTOR_SIZE - 1))
+        {
+            if (!blockdev_read(volume->dev, sector + full_sectors, 1, sector_buf))
+                return false;
+            memcpy(dest + (full_sectors << SECTOR_SHIFT), sector_buf, run_bytes & (SECTOR_SIZE - 1));
+        }
+
+        dest        += run_bytes;
+        remaining   -= run_bytes;
+    }
+
+    return true;
+}
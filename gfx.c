@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: 2D drawing primitives for linear framebuffers
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <cpu.h>
+#include <gfx.h>
+
+extern linear_framebuffer_t fb;
+
+static boolean_t sse2;
+
+#define GFX_ROW(y)  ((uint32_t *) ((uint8_t *) (uint32_t) fb.base + (y) * fb.pitch))
+
+void gfx_init(void)
+{
+    sse2 = cpu_enable_sse2();
+}
+
+// Fill count pixels. The framebuffer is write-combining, so the bulk of the span is written 64 bytes at a time with
+// non-temporal stores that don't pull anything into the cache. Nothing is clipped, and the stores aren't fenced until
+// gfx_flush().
+void gfx_fill_span(uint32_t *dst, uint32_t count, uint32_t color)
+{
+    if (sse2)
+    {
+        while (count && ((uint32_t) dst & 15))
+        {
+            *dst++ = color;
+            count--;
+        }
+
+        uint32_t blocks = count >> 4;
+        if (blocks)
+        {
+            asm volatile("movd      %[color], %%xmm0\n\t"
+                         "pshufd    $0, %%xmm0, %%xmm0\n"
+                         "1:\n\t"
+                         "movntdq   %%xmm0, 0(%[dst])\n\t"
+                         "movntdq   %%xmm0, 16(%[dst])\n\t"
+                         "movntdq   %%xmm0, 32(%[dst])\n\t"
+                         "movntdq   %%xmm0, 48(%[dst])\n\t"
+                         "add       $64, %[dst]\n\t"
+                         "dec       %[blocks]\n\t"
+                         "jnz       1b"
+                         : [dst] "+r"(dst), [blocks] "+r"(blocks)
+                         : [color] "r"(color)
+                         : "xmm0", "memory", "cc");
+            count &= 15;
+        }
+    }
+
+    while (count--)
+        *dst++ = color;
+}
+
+// Copy count pixels front to back. The source may be unaligned.
+static void gfx_copy_span(uint32_t *dst, const uint32_t *src, uint32_t count)
+{
+    if (sse2)
+    {
+        while (count && ((uint32_t) dst & 15))
+        {
+            *dst++ = *src++;
+            count--;
+        }
+
+        uint32_t blocks = count >> 4;
+        if (blocks)
+        {
+            asm volatile("1:\n\t"
+                         "movdqu    0(%[src]), %%xmm0\n\t"
+                         "movdqu    16(%[src]), %%xmm1\n\t"
+                         "movdqu    32(%[src]), %%xmm2\n\t"
+                         "movdqu    48(%[src]), %%xmm3\n\t"
+                         "movntdq   %%xmm0, 0(%[dst])\n\t"
+                         "movntdq   %%xmm1, 16(%[dst])\n\t"
+                         "movntdq   %%xmm2, 32(%[dst])\n\t"
+                         "movntdq   %%xmm3, 48(%[dst])\n\t"
+                         "add       $64, %[src]\n\t"
+                         "add       $64, %[dst]\n\t"
+                         "dec       %[blocks]\n\t"
+                         "jnz       1b"
+                         : [dst] "+r"(dst), [src] "+r"(src), [blocks] "+r"(blocks)
+                         :
+                         : "xmm0", "xmm1", "xmm2", "xmm3", "memory", "cc");
+            count &= 15;
+        }
+    }
+
+    while (count--)
+        *dst++ = *src++;
+}
+
+// Clip a rectangle to the screen. Returns false if nothing is left.
+static boolean_t gfx_clip(uint32_t x, uint32_t y, uint32_t *width, uint32_t *height)
+{
+    if (!fb.enabled || x >= fb.width || y >= fb.height)
+        return false;
+
+    if (*width > fb.width - x)
+        *width = fb.width - x;
+    if (*height > fb.height - y)
+        *height = fb.height - y;
+
+    return *width && *height;
+}
+
+void gfx_fill_rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t color)
+{
+    if (!gfx_clip(x, y, &width, &height))
+        return;
+
+    // Full-width rectangles without row padding are one contiguous span
+    if (x == 0 && width == fb.width && fb.pitch == width * 4)
+    {
+        gfx_fill_span(GFX_ROW(y), width * height, color);
+    }
+    else
+    {
+        for (uint32_t row = 0; row < height; row++)
+            gfx_fill_span(GFX_ROW(y + row) + x, width, color);
+    }
+
+    if (sse2)
+        sfence();
+}
+
+// Copy a width x height image with src_pitch bytes per row to the screen.
+void gfx_blit(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint32_t *src, uint32_t src_pitch)
+{
+    if (!gfx_clip(x, y, &width, &height))
+        return;
+
+    for (uint32_t row = 0; row < height; row++)
+    {
+        gfx_copy_span(GFX_ROW(y + row) + x, src, width);
+        src = (const uint32_t *) ((const uint8_t *) src + src_pitch);
+    }
+
+    if (sse2)
+        sfence();
+}
+
+// Move whole rows of the screen, e.g. for scrolling. The ranges may overlap.
+void gfx_copy_rows(uint32_t dst_y, uint32_t src_y, uint32_t rows)
+{
+    if (!fb.enabled || dst_y >= fb.height || src_y >= fb.height)
+        return;
+
+    if (rows > fb.height - dst_y)
+        rows = fb.height - dst_y;
+    if (rows > fb.height - src_y)
+        rows = fb.height - src_y;
+
+    if (dst_y <= src_y)
+    {
+        for (uint32_t row = 0; row < rows; row++)
+            gfx_copy_span(GFX_ROW(dst_y + row), GFX_ROW(src_y + row), fb.width);
+    }
+    else
+    {
+        for (uint32_t row = rows; row > 0; row--)
+            gfx_copy_span(GFX_ROW(dst_y + row - 1), GFX_ROW(src_y + row - 1), fb.width);
+    }
+
+    if (sse2)
+        sfence();
+}
+
+// Address of a pixel for gfx_fill_span(), or NULL if it's off screen
+uint32_t *gfx_pixel_addr(uint32_t x, uint32_t y)
+{
+    if (!fb.enabled || x >= fb.width || y >= fb.height)
+        return NULL;
+
+    return GFX_ROW(y) + x;
+}
+
+// Make the non-temporal stores of gfx_fill_span() visible
+void gfx_flush(void)
+{
+    if (sse2)
+        sfence();
+}
+
+uint32_t gfx_get_pixel(uint32_t x, uint32_t y)
+{
+    if (!fb.enabled || x >= fb.width || y >= fb.height)
+        return 0;
+
+    return GFX_ROW(y)[x];
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - ATA (IDE) disk driver
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "blockdev.h"
+
+// Legacy (compatibility mode) ports
+#define ATA_PRIMARY_CMD         0x1F0
+#define ATA_PRIMARY_CTRL        0x3F6
+#define ATA_SECONDARY_CMD       0x170
+#define ATA_SECONDARY_CTRL      0x376
+
+// Command block registers, relative to the command base
+#define ATA_REG_DATA            0
+#define ATA_REG_ERROR           1
+#define ATA_REG_FEATURES        1
+#define ATA_REG_SECCOUNT        2
+#define ATA_REG_LBA0            3
+#define ATA_REG_LBA1            4
+#define ATA_REG_LBA2            5
+#define ATA_REG_DEVICE          6
+#define ATA_REG_STATUS          7
+#define ATA_REG_COMMAND         7
+
+// Control block register, relative to the control base
+#define ATA_REG_ALTSTATUS       0
+#define ATA_REG_DEVCTRL         0
+
+#define ATA_SR_BSY              0x80
+#define ATA_SR_DRDY             0x40
+#define ATA_SR_DF               0x20
+#define ATA_SR_DRQ              0x08
+#define ATA_SR_ERR              0x01
+
+#define ATA_DEVCTRL_NIEN        0x02
+
+#define ATA_DEVICE_LBA          0x40
+#define ATA_DEVICE_SLAVE        0x10
+
+#define ATA_CMD_READ_PIO        0x20
+#define ATA_CMD_READ_PIO_EXT    0x24
+#define ATA_CMD_READ_DMA        0xC8
+#define ATA_CMD_READ_DMA_EXT    0x25
+#define ATA_CMD_IDENTIFY        0xEC
+
+// IDENTIFY DEVICE words
+#define ATA_ID_CAPABILITIES     49
+#define ATA_ID_LBA28_SECTORS    60
+#define ATA_ID_COMMAND_SET_2    83
+#define ATA_ID_UDMA_MODES       88
+#define ATA_ID_LBA48_SECTORS    100
+
+#define ATA_CAP_DMA             (1 << 8)
+#define ATA_CMDSET2_LBA48       (1 << 10)
+
+// Bus master IDE registers, relative to the channel's bus master base
+#define ATA_BM_COMMAND          0
+#define ATA_BM_STATUS           2
+#define ATA_BM_PRDT             4
+#define ATA_BM_SECONDARY        8
+
+#define ATA_BM_CMD_START        0x01
+#define ATA_BM_CMD_READ         0x08    // bus master writes to memory
+
+#define ATA_BM_SR_ACTIVE        0x01
+#define ATA_BM_SR_ERR           0x02
+#define ATA_BM_SR_IRQ           0x04
+#define ATA_BM_SR_DMA_CAPABLE0  0x20
+#define ATA_BM_SR_DMA_CAPABLE1  0x40
+
+#define ATA_PRD_EOT             0x80000000
+#define ATA_PRD_MAX_BYTES       0x10000
+
+#define ATA_MAX_DRIVES          4
+
+/* Functions */
+extern uint32_t ata_probe(block_device_t **disks, uint32_t max_disks);
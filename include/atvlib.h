@@ -15,4 +15,5 @@
 
 extern mach_boot_args_t     *gBA;
 extern boolean_t            verbose;
-extern noreturn void halt(void);
\ No newline at end of file
+extern noreturn void halt(void);
+extern boolean_t cmdline_get(const char *key, char *value, uint32_t len);
\ No newline at end of file
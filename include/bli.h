@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - Boot Loader Interface EFI variables
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// This header is shared with the host-side test (tests/bli_test.c), so it must not depend on anything besides the
+// fixed-width integer types and efi.h.
+
+// See https://systemd.io/BOOT_LOADER_INTERFACE/. The variables are volatile and only visible to an OS that has EFI
+// runtime services, e.g. Linux booted in EFI mode through efivarfs.
+#define LOADER_VARIABLE_GUID        EFI_GUID(0x4a67b082, 0x0a4c, 0x41cf, 0xb6, 0xc7, 0x44, 0x0b, 0x29, 0xbb, 0x8c, 0x4f)
+#define LOADER_VARIABLE_ATTRIBUTES  (EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS)
+
+#define LOADER_INFO                 "atv-linux-loader"
+
+// Linux is still started in legacy mode, so nothing can read the variables yet. Until it can, setting them is opt-in
+// with "atv.efivars=1" in the Kernel Flags.
+#define BLI_CMDLINE_KEY             "atv.efivars"
+
+#define BLI_MAX_VALUE_LEN           64
+
+// Where the variables go. The loader calls SetVariable() in the firmware's runtime services; the host test records
+// them instead.
+typedef struct _bli_ops_t
+{
+    efi_status_t    (*set_variable)(void *context, uint16_t *name, efi_guid_t *vendor, uint32_t attributes,
+                                    uint32_t data_size, void *data);
+    void            *context;
+} bli_ops_t;
+
+// What gets exported
+typedef struct _bli_info_t
+{
+    uint32_t        init_usec;      // when the loader started, in microseconds since reset; 0 if unknown
+    uint32_t        exec_usec;      // when the kernel is started
+    const uint16_t  *fw_vendor;     // UTF-16 firmware vendor from the system table, may be NULL
+    uint32_t        fw_revision;
+    uint32_t        efi_revision;   // hdr.revision of the system table
+} bli_info_t;
+
+/* Functions */
+extern uint32_t bli_set_variables(const bli_ops_t *ops, const bli_info_t *info);
+extern void bli_mark_init(void);
+extern void bli_export(efi_system_table_32_t *systbl);
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - block device layer
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#define SECTOR_SIZE         512
+#define SECTOR_SHIFT        9
+
+#define BLOCKDEV_MAX_PARTITIONS 128 // the usual size of a GPT entry array
+
+typedef struct _block_device_t block_device_t;
+
+// Read count sectors starting at lba straight into buf. Returns false on error.
+typedef boolean_t (*block_read_t)(block_device_t *dev, uint64_t lba, uint32_t count, void *buf);
+
+struct _block_device_t
+{
+    char            name[16];
+    uint64_t        num_sectors;
+    uint64_t        offset;     // first sector, for partitions
+    block_read_t    read;
+    void            *priv;
+};
+
+/* Functions */
+extern boolean_t blockdev_read(block_device_t *dev, uint64_t lba, uint32_t count, void *buf);
+extern boolean_t blockdev_partition(block_device_t *disk, uint32_t index, block_device_t *part, char *label,
+                                    uint32_t label_len);
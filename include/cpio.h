@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - cpio (newc) archive support
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// See Linux/Documentation/driver-api/early-userspace/buffer-format.rst. Each entry is a 110 byte ASCII header, the
+// NUL-terminated name and the file data; the name and the data are each padded so the next part starts on a 4 byte
+// boundary. An archive ends with an entry named TRAILER!!!, and Linux accepts several archives back to back with NUL
+// padding in between.
+#define CPIO_NEWC_MAGIC         "070701"
+#define CPIO_NEWC_CRC_MAGIC     "070702"
+#define CPIO_MAGIC_LEN          6
+#define CPIO_HEADER_SIZE        110
+#define CPIO_TRAILER            "TRAILER!!!"
+
+#define CPIO_MODE_TYPE_MASK     0170000
+#define CPIO_MODE_REGULAR       0100000
+
+typedef struct _cpio_newc_header_t
+{
+    char    magic[CPIO_MAGIC_LEN];
+    char    ino[8];
+    char    mode[8];
+    char    uid[8];
+    char    gid[8];
+    char    nlink[8];
+    char    mtime[8];
+    char    filesize[8];
+    char    devmajor[8];
+    char    devminor[8];
+    char    rdevmajor[8];
+    char    rdevminor[8];
+    char    namesize[8];    // including the NUL
+    char    check[8];
+} cpio_newc_header_t;
+
+// Decides whether an entry is dropped. name has any leading "./" or "/" removed.
+typedef boolean_t (*cpio_filter_t)(const char *name, uint32_t mode, void *context);
+
+typedef struct _cpio_prune_stats_t
+{
+    uint32_t    kept;
+    uint32_t    dropped;
+    uint32_t    dropped_bytes;
+} cpio_prune_stats_t;
+
+/* Functions */
+extern boolean_t cpio_match(const char *pattern, uint32_t len, const char *name);
+extern uint32_t cpio_prune(void *dst, const void *src, uint32_t len, cpio_filter_t drop, void *context,
+                           cpio_prune_stats_t *stats);
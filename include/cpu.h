@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: x86 CPU helpers
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#define CPUID_FEATURES          1
+#define CPUID_EDX_TSC           (1 << 4)
+#define CPUID_EDX_FXSR          (1 << 24)
+#define CPUID_EDX_SSE           (1 << 25)
+#define CPUID_EDX_SSE2          (1 << 26)
+
+#define CR0_MP                  (1 << 1)
+#define CR0_EM                  (1 << 2)
+#define CR4_OSFXSR              (1 << 9)
+#define CR4_OSXMMEXCPT          (1 << 10)
+
+static inline void cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+    asm volatile("cpuid" : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx) : "a"(leaf), "c"(0));
+}
+
+static inline uint32_t read_cr0(void)
+{
+    uint32_t value;
+    asm volatile("mov %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr0(uint32_t value)
+{
+    asm volatile("mov %0, %%cr0" :: "r"(value));
+}
+
+static inline uint32_t read_cr4(void)
+{
+    uint32_t value;
+    asm volatile("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr4(uint32_t value)
+{
+    asm volatile("mov %0, %%cr4" :: "r"(value));
+}
+
+static inline uint64_t rdtsc(void)
+{
+    uint64_t value;
+    asm volatile("rdtsc" : "=A"(value));
+    return value;
+}
+
+// Make sure all non-temporal stores are visible
+static inline void sfence(void)
+{
+    asm volatile("sfence" ::: "memory");
+}
+
+/* Functions */
+extern boolean_t cpu_enable_sse2(void);
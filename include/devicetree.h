@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - XNU flattened device tree support
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// See xnu-1228 pexpert/pexpert/device_tree.h
+#define DT_PROPERTY_NAME_LENGTH 32
+
+typedef struct _dt_property_t
+{
+    char        name[DT_PROPERTY_NAME_LENGTH];
+    uint32_t    length; // length of the value, which follows and is padded to a multiple of 4
+} dt_property_t;
+
+typedef struct _dt_node_t
+{
+    uint32_t    num_properties; // properties follow this header
+    uint32_t    num_children;   // children follow the last property
+} dt_node_t;
+
+// Value of the properties in /chosen/memory-map
+typedef struct _dt_memory_range_t
+{
+    uint32_t    paddr;
+    uint32_t    length;
+} dt_memory_range_t;
+
+// Every extension loaded by boot.efi gets a "Driver-<address>" property in /chosen/memory-map pointing to one of
+// these. The Info.plist and the executable follow it in the same allocation. See BootDriverInfo in xnu-1228
+// libsa/catalogue.cpp
+typedef struct _booter_kext_file_info_t
+{
+    uint32_t    info_dict_paddr;    // Info.plist as XML, not necessarily NUL terminated
+    uint32_t    info_dict_length;
+    uint32_t    executable_paddr;
+    uint32_t    executable_length;
+} booter_kext_file_info_t;
+
+#define DT_DRIVER_PREFIX    "Driver-"
+
+/* Functions */
+extern dt_node_t *dt_root(void);
+extern dt_node_t *dt_find_node(const char *path);
+extern dt_property_t *dt_next_property(dt_node_t *node, dt_property_t *prev);
+extern void *dt_get_property(dt_node_t *node, const char *name, uint32_t *length);
+extern const uint8_t *dt_find_extension(const char *bundle_id, uint32_t *length);
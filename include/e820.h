@@ -23,3 +23,4 @@ struct boot_e820_entry {
 #define E820_PMEM	7
 
 extern uint8_t efi_to_e820_map(efi_memory_desc_t *efi_map, uint32_t efi_map_size, uint32_t efi_desc_size, struct boot_e820_entry *output_map);
+extern boolean_t e820_change_type(struct boot_e820_entry *memory_map, uint8_t *num_entries, uint64_t addr, uint64_t size, uint32_t from, uint32_t to);
@@ -59,6 +59,41 @@ typedef struct {
     uint32_t tables;
 } efi_system_table_32_t;
 
+/*
+ * EFI Runtime Services table
+ */
+#define EFI_RUNTIME_SERVICES_SIGNATURE ((uint64_t)0x56524553544e5552ULL)
+
+typedef uint32_t efi_status_t;
+
+#define EFI_SUCCESS		0
+
+#define EFI_VARIABLE_NON_VOLATILE	0x0000000000000001
+#define EFI_VARIABLE_BOOTSERVICE_ACCESS	0x0000000000000002
+#define EFI_VARIABLE_RUNTIME_ACCESS	0x0000000000000004
+
+typedef struct {
+    efi_table_hdr_t hdr;
+    uint32_t get_time;
+    uint32_t set_time;
+    uint32_t get_wakeup_time;
+    uint32_t set_wakeup_time;
+    uint32_t set_virtual_address_map;
+    uint32_t convert_pointer;
+    uint32_t get_variable;
+    uint32_t get_next_variable;
+    uint32_t set_variable;
+    uint32_t get_next_high_mono_count;
+    uint32_t reset_system;
+    uint32_t update_capsule;
+    uint32_t query_capsule_caps;
+    uint32_t query_variable_info;
+} efi_runtime_services_32_t;
+
+/* All IA-32 EFI services use the cdecl calling convention */
+typedef efi_status_t efi_set_variable_t (uint16_t *name, efi_guid_t *vendor, uint32_t attr, uint32_t data_size,
+                                         void *data);
+
 /*
  * Memory map descriptor:
  */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - read-only FAT32 support
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "blockdev.h"
+
+#define FAT32_EOC               0x0FFFFFF8  // clusters at or above this end a chain
+#define FAT32_CLUSTER_MASK      0x0FFFFFFF
+
+#define FAT_ATTR_VOLUME_ID      0x08
+#define FAT_ATTR_DIRECTORY      0x10
+#define FAT_ATTR_LFN            0x0F
+
+#define FAT_DIRENT_FREE         0xE5
+#define FAT_DIRENT_END          0x00
+
+typedef struct _fat32_bpb_t
+{
+    uint8_t     jump[3];
+    char        oem_name[8];
+    uint16_t    bytes_per_sector;
+    uint8_t     sectors_per_cluster;
+    uint16_t    reserved_sectors;
+    uint8_t     num_fats;
+    uint16_t    root_entries;       // 0 on FAT32
+    uint16_t    total_sectors_16;
+    uint8_t     media;
+    uint16_t    fat_size_16;        // 0 on FAT32
+    uint16_t    sectors_per_track;
+    uint16_t    num_heads;
+    uint32_t    hidden_sectors;
+    uint32_t    total_sectors_32;
+    uint32_t    fat_size_32;
+    uint16_t    ext_flags;
+    uint16_t    fs_version;
+    uint32_t    root_cluster;
+    uint16_t    fs_info;
+    uint16_t    backup_boot_sector;
+    uint8_t     reserved[12];
+    uint8_t     drive_number;
+    uint8_t     reserved1;
+    uint8_t     boot_signature;
+    uint32_t    volume_id;
+    char        volume_label[11];
+    char        fs_type[8];
+} __attribute__((packed)) fat32_bpb_t;
+
+typedef struct _fat_dirent_t
+{
+    char        name[11];
+    uint8_t     attr;
+    uint8_t     nt_reserved;
+    uint8_t     create_time_tenth;
+    uint16_t    create_time;
+    uint16_t    create_date;
+    uint16_t    access_date;
+    uint16_t    cluster_high;
+    uint16_t    write_time;
+    uint16_t    write_date;
+    uint16_t    cluster_low;
+    uint32_t    size;
+} __attribute__((packed)) fat_dirent_t;
+
+typedef struct _fat32_volume_t
+{
+    block_device_t  *dev;
+    uint32_t        sectors_per_cluster;
+    uint32_t        cluster_shift;      // log2(sectors_per_cluster)
+    uint32_t        fat_start;          // first sector of the first FAT
+    uint32_t        data_start;         // first sector of cluster 2
+    uint32_t        num_clusters;
+    uint32_t        root_cluster;
+    char            label[12];
+} fat32_volume_t;
+
+typedef struct _fat32_file_t
+{
+    fat32_volume_t  *volume;
+    uint32_t        first_cluster;
+    uint32_t        size;
+} fat32_file_t;
+
+/* Functions */
+extern boolean_t fat32_mount(block_device_t *dev, fat32_volume_t *volume);
+extern boolean_t fat32_open(fat32_volume_t *volume, const char *name, fat32_file_t *file);
+extern boolean_t fat32_read(fat32_file_t *file, void *buf);
@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: 2D drawing primitives for linear framebuffers
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// All colors are in the framebuffer's native format (see RGBA_TO_NATIVE) and all coordinates are in pixels.
+// Rectangles are clipped to the screen.
+
+/* Functions */
+extern void gfx_init(void);
+extern void gfx_fill_rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t color);
+extern void gfx_blit(uint32_t x, uint32_t y, uint32_t width, uint32_t height, const uint32_t *src,
+                     uint32_t src_pitch);
+extern void gfx_copy_rows(uint32_t dst_y, uint32_t src_y, uint32_t rows);
+extern uint32_t gfx_get_pixel(uint32_t x, uint32_t y);
+extern uint32_t *gfx_pixel_addr(uint32_t x, uint32_t y);
+extern void gfx_fill_span(uint32_t *dst, uint32_t count, uint32_t color);
+extern void gfx_flush(void);
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - pre-boot memory test
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Enabled with "atv.memtest=quick" or "atv.memtest=full" in the Kernel Flags.
+#define MEMTEST_CMDLINE_KEY     "atv.memtest"
+
+#define MEMTEST_OFF             0
+#define MEMTEST_QUICK           1   // address test, then one moving inversions pattern within a time budget
+#define MEMTEST_FULL            2   // address test and all moving inversions patterns, no time budget
+
+#define MEMTEST_QUICK_BUDGET_MS 1500
+#define MEMTEST_CHUNK_SIZE      0x100000    // the budget is checked between moving inversions chunks
+#define MEMTEST_MAX_BAD_RANGES  32
+#define MEMTEST_MAX_PIECES      64          // pieces whose bandwidth is reported
+
+// A range of memory the test must leave alone
+typedef struct _memtest_range_t
+{
+    uint32_t    start;
+    uint32_t    end;
+} memtest_range_t;
+
+/* Functions */
+extern uint8_t memtest_run(struct boot_e820_entry *memory_map, uint8_t num_entries, const memtest_range_t *skip,
+                           uint32_t num_skip);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - embedded payload container
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// This header is shared with the host-side packer (tools/mkpayload.c), so it must not depend on anything
+// besides the fixed-width integer types.
+
+// Container layout inside mach_kernel:
+//
+//  +------------------+  offset 0
+//  | payload_header_t |
+//  +------------------+  header_size
+//  | payload_entry_t  |  num_entries * entry_size
+//  | ...              |
+//  +------------------+
+//  | entry data       |  each entry starts at a PAYLOAD_DATA_ALIGN boundary
+//  | ...              |
+//  +------------------+  total_size
+
+#define PAYLOAD_MAGIC           0x4C595041 // "APYL"
+#define PAYLOAD_VERSION         1
+
+#define PAYLOAD_DATA_ALIGN      16
+#define PAYLOAD_OVERLAY_ALIGN   4   // Linux skips NUL padding between concatenated archives in 4 byte steps
+#define PAYLOAD_NAME_LEN        32
+
+// Entry data is only checked against its CRC32 with "atv.verify=1" in the Kernel Flags; the entry table always is.
+#define PAYLOAD_VERIFY_CMDLINE_KEY  "atv.verify"
+
+// Entry types
+#define PAYLOAD_TYPE_NONE       0
+#define PAYLOAD_TYPE_KERNEL     1   // Linux bzImage
+#define PAYLOAD_TYPE_INITRAMFS  2   // initramfs/initrd image
+#define PAYLOAD_TYPE_OVERLAY    3   // cpio archive appended to the initramfs
+#define PAYLOAD_TYPE_PRUNE      4   // initramfs prune manifest, see prune.h
+
+// Storage codecs
+#define PAYLOAD_CODEC_NONE      0   // stored as-is
+
+typedef struct _payload_header_t
+{
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    header_size;    // size of this header
+    uint32_t    entry_size;     // size of one payload_entry_t
+    uint32_t    num_entries;
+    uint32_t    total_size;     // header + entry table + data
+    uint32_t    table_crc32;    // CRC32 of the entry table
+} __attribute__((packed)) payload_header_t;
+
+typedef struct _payload_entry_t
+{
+    uint32_t    type;
+    uint32_t    flags;
+    uint32_t    offset;         // offset of the data from the start of the container
+    uint32_t    stored_size;    // size of the data as stored in the container
+    uint32_t    size;           // size of the data once decoded
+    uint32_t    alignment;      // required alignment of the load address
+    uint32_t    codec;
+    uint32_t    crc32;          // CRC32 of the stored data
+    char        name[PAYLOAD_NAME_LEN];
+} __attribute__((packed)) payload_entry_t;
+
+/* Functions */
+extern void payload_init(void);
+extern payload_entry_t *payload_next(payload_entry_t *prev);
+extern payload_entry_t *payload_find(uint32_t type, payload_entry_t *prev);
+extern const uint8_t *payload_data(payload_entry_t *entry);
+extern uint32_t payload_load(payload_entry_t *entry, void *dest);
+extern uint32_t crc32(uint32_t crc, const void *buf, uint32_t len);
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - PCI configuration space access
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#define PCI_CONFIG_ADDRESS  0xCF8
+#define PCI_CONFIG_DATA     0xCFC
+
+#define PCI_MAX_BUS         256
+#define PCI_MAX_DEVICE      32
+#define PCI_MAX_FUNCTION    8
+
+// Configuration space registers
+#define PCI_VENDOR_ID       0x00
+#define PCI_COMMAND         0x04
+#define PCI_CLASS_REVISION  0x08    // class << 24 | subclass << 16 | prog_if << 8 | revision
+#define PCI_HEADER_TYPE     0x0E
+#define PCI_BAR0            0x10
+
+#define PCI_COMMAND_IO      (1 << 0)
+#define PCI_COMMAND_MASTER  (1 << 2)
+
+#define PCI_BAR_IO          1
+#define PCI_BAR_IO_MASK     0xFFFFFFFC
+
+// Classes
+#define PCI_CLASS_STORAGE_IDE   0x0101
+
+typedef struct _pci_device_t
+{
+    uint8_t     bus;
+    uint8_t     device;
+    uint8_t     function;
+    uint8_t     prog_if;
+} pci_device_t;
+
+/* Functions */
+extern uint32_t pci_read32(pci_device_t *dev, uint8_t reg);
+extern uint16_t pci_read16(pci_device_t *dev, uint8_t reg);
+extern void pci_write16(pci_device_t *dev, uint8_t reg, uint16_t value);
+extern boolean_t pci_find_class(uint16_t class, uint32_t index, pci_device_t *dev);
@@ -0,0 +1,21 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - model-aware initramfs pruning
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// The prune manifest is a text payload (PAYLOAD_TYPE_PRUNE) with one rule per line:
+//
+//  <model|*> <pattern>
+//
+// `model` is matched against the SMBIOS product name (e.g. AppleTV1,1), `*` applies to every model. `pattern` is a
+// path inside the initramfs where `*` matches any run of characters (including '/') and `?` any single one. A pattern
+// also matches everything below a directory it matches. Lines starting with '#' are comments.
+#define PRUNE_MAX_RULES     256
+#define PRUNE_MODEL_LEN     64
+
+/* Functions */
+extern boolean_t prune_init(efi_system_table_32_t *systbl);
+extern uint32_t prune_initramfs(void *dst, const void *src, uint32_t len);
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - SMBIOS support
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// See the DMTF SMBIOS specification (DSP0134), 2.x entry point
+#define SMBIOS_ANCHOR               "_SM_"
+
+#define SMBIOS_TYPE_SYSTEM          1
+#define SMBIOS_TYPE_END             127
+
+// String fields of the System Information (type 1) structure
+#define SMBIOS_SYSTEM_MANUFACTURER  0x04
+#define SMBIOS_SYSTEM_PRODUCT_NAME  0x05    // e.g. "AppleTV1,1"
+
+typedef struct _smbios_entry_point_t
+{
+    char        anchor[4];              // "_SM_"
+    uint8_t     checksum;
+    uint8_t     length;
+    uint8_t     major_version;
+    uint8_t     minor_version;
+    uint16_t    max_structure_size;
+    uint8_t     revision;
+    uint8_t     formatted_area[5];
+    char        intermediate_anchor[5]; // "_DMI_"
+    uint8_t     intermediate_checksum;
+    uint16_t    table_length;           // 0x16
+    uint32_t    table_address;          // 0x18
+    uint16_t    num_structures;         // 0x1C
+    uint8_t     bcd_revision;
+} __attribute__((packed)) smbios_entry_point_t;
+
+// Every structure starts with this header. The formatted area is `length` bytes long including the header and is
+// followed by a set of NUL-terminated strings, ended by an extra NUL.
+typedef struct _smbios_header_t
+{
+    uint8_t     type;
+    uint8_t     length;
+    uint16_t    handle;
+} __attribute__((packed)) smbios_header_t;
+
+/* Functions */
+extern smbios_entry_point_t *smbios_find(efi_system_table_32_t *systbl);
+extern boolean_t smbios_get_string(efi_system_table_32_t *systbl, uint8_t type, uint8_t field, char *buf,
+                                   uint32_t len);
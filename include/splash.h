@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Boot splash and progress bar
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// Splash images are run-length encoded by tools/mksplash as (count, pixel) pairs of 32-bit words, with pixels
+// already in x8r8g8b8 format. Runs never cross the end of a row. The image is only drawn if the framebuffer uses that
+// format too.
+#define SPLASH_DEPTH        32
+#define SPLASH_RED_SHIFT    16
+#define SPLASH_GREEN_SHIFT  8
+#define SPLASH_BLUE_SHIFT   0
+
+/* Functions */
+extern void splash_show(void);
+extern void splash_progress(uint32_t done, uint32_t total);
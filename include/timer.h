@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: TSC based timekeeping
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// The PIT is only used once, to find out how fast the TSC runs
+#define PIT_FREQUENCY       1193182
+#define PIT_CH2_DATA        0x42
+#define PIT_COMMAND         0x43
+#define PIT_CH2_GATE        0x61
+
+#define PIT_GATE_ENABLE     0x01
+#define PIT_SPEAKER_ENABLE  0x02
+#define PIT_CH2_OUT         0x20
+
+#define PIT_CMD_CH2_MODE0   0xB0    // channel 2, lobyte/hibyte, interrupt on terminal count
+
+#define TIMER_CALIBRATE_MS  10
+
+/* Functions */
+extern void timer_init(void);
+extern uint32_t timer_tsc_khz(void);
+extern uint64_t timer_ticks_to_us(uint64_t ticks);
+extern uint32_t timer_us_since(uint64_t start);
+extern uint64_t udiv64(uint64_t n, uint32_t d);
@@ -5,25 +5,33 @@
  */
 
 #include <linux.h>
+#include <payload.h>
+#include <devicetree.h>
+#include <ata.h>
+#include <fat32.h>
+#include <splash.h>
+#include <memtest.h>
+#include <smbios.h>
+#include <prune.h>
+#include <bli.h>
 
-// Kernel and initramfs files.
+#define LINUX_KERNEL_LOAD_INCREMENT 0x100000
+#define SMBIOS_TABLE_LOW 0xF0000
 
-#include "kernel_bin.h"
+// CFBundleIdentifier of the boot.efi extension an initramfs can be shipped in, see `make initramfs_kext`
+#define INITRAMFS_EXTENSION "org.linux.initramfs"
 
-#ifdef INITRAMFS
-#include "initramfs_bin.h"
-#else
-unsigned char   initramfs_bin[] = {};
-unsigned int    initramfs_bin_len = 0;
-#endif
+// Where to look for an initramfs on disk if mach_kernel doesn't carry one
+#define INITRAMFS_FILE          "initrd.img"
+#define BOOT_PARTITION_LABEL    "boot"
 
-#define LINUX_KERNEL_LOAD_INCREMENT 0x100000
-#define SMBIOS_TABLE_LOW 0xF0000
+// Steps shown on the splash progress bar: kernel, initramfs, overlays, boot parameters
+#define LOAD_STAGES 4
 
 // Video parameters
 extern linear_framebuffer_t fb;
 
-#define ROUND_UP(num, multiple) (num + (multiple - 1)) & ~(multiple - 1)
+#define ROUND_UP(num, multiple) (((num) + ((multiple) - 1)) & ~((multiple) - 1))
 
 static void *get_rsdp_from_systbl(efi_system_table_32_t *systbl)
 {
@@ -47,17 +55,8 @@ static void *get_rsdp_from_systbl(efi_system_table_32_t *systbl)
 
 static void copy_smbios_to_lowmem(efi_system_table_32_t *systbl)
 {
-    void *smbios_tbl;
+    smbios_entry_point_t *smbios_tbl = smbios_find(systbl);
 
-    efi_config_table_32_t *config_tables = (efi_config_table_32_t *) systbl->tables;
-
-    for (int i = 0; i < systbl->nr_tables; i++)
-    {
-        if (efi_guidcmp(config_tables[i].guid, SMBIOS_TABLE_GUID) == 0)
-        {
-            smbios_tbl = config_tables[i].table;
-        }
-    }
     if (smbios_tbl)
     {
         trace("Copying SMBIOS to low memory...");
@@ -66,12 +65,112 @@ static void copy_smbios_to_lowmem(efi_system_table_32_t *systbl)
     }
 }
 
+// Look for INITRAMFS_FILE on the boot partition of the IDE disks.
+static boolean_t find_initramfs_on_disk(fat32_file_t *file)
+{
+    static block_device_t   part;
+    static fat32_volume_t   volume;
+    block_device_t          *disks[ATA_MAX_DRIVES];
+    char                    label[40];
+
+    uint32_t num_disks = ata_probe(disks, ATA_MAX_DRIVES);
+
+    for (uint32_t i = 0; i < num_disks; i++)
+    {
+        for (uint32_t index = 0; blockdev_partition(disks[i], index, &part, label, sizeof(label)); index++)
+        {
+            if (!fat32_mount(&part, &volume))
+                continue;
+
+            // GParted sets the filesystem label; other tools may only set the GPT partition name
+            if (strcasecmp(label, BOOT_PARTITION_LABEL) != 0 && strcasecmp(volume.label, BOOT_PARTITION_LABEL) != 0)
+                continue;
+
+            if (fat32_open(&volume, INITRAMFS_FILE, file))
+            {
+                trace("Found %s on %s partition %d (%d bytes).\n", INITRAMFS_FILE, disks[i]->name, index, file->size);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 noreturn void load_linux(void)
 {
     struct boot_params  bp;
+    payload_entry_t     *kernel_entry = NULL;
+    payload_entry_t     *initramfs_entry = NULL;
+    const uint8_t       *initramfs_ext;
+    uint32_t            initramfs_ext_len;
+    fat32_file_t        initramfs_file;
+    boolean_t           initramfs_on_disk = false;
 
     trace("Initializing Linux loader...\n");
 
+    // Find out what mach_kernel carries. Entries are only verified and copied once they're used.
+    payload_init();
+
+    for (payload_entry_t *entry = payload_next(NULL); entry; entry = payload_next(entry))
+    {
+        switch (entry->type)
+        {
+            case PAYLOAD_TYPE_KERNEL:
+                if (!kernel_entry)
+                    kernel_entry = entry;
+                break;
+            case PAYLOAD_TYPE_INITRAMFS:
+                if (!initramfs_entry)
+                    initramfs_entry = entry;
+                break;
+            case PAYLOAD_TYPE_OVERLAY:
+                // Appended to whichever base image we end up with
+                break;
+            case PAYLOAD_TYPE_PRUNE:
+                // Read by prune_init() once the initramfs is known
+                break;
+            default:
+                warn("Ignoring unknown payload \"%s\" (type %d).\n", entry->name, entry->type);
+                break;
+        }
+    }
+
+    if (!kernel_entry)
+        fail(__FILE__, __LINE__, "No kernel found in mach_kernel!");
+
+    const uint8_t   *kernel_bin     = payload_data(kernel_entry);
+    uint32_t        kernel_bin_len  = kernel_entry->size;
+    uint32_t        initramfs_len   = initramfs_entry ? initramfs_entry->size : 0;
+
+    // An initramfs shipped as an extension can be updated without rebuilding mach_kernel, so it takes precedence.
+    initramfs_ext = dt_find_extension(INITRAMFS_EXTENSION, &initramfs_ext_len);
+    if (initramfs_ext)
+    {
+        trace("Found %s at 0x%X (%d bytes).\n", INITRAMFS_EXTENSION, (uint32_t) initramfs_ext, initramfs_ext_len);
+        if (initramfs_entry)
+        {
+            warn("Ignoring the initramfs embedded in mach_kernel.\n");
+        }
+        initramfs_entry = NULL;
+        initramfs_len   = initramfs_ext_len;
+    }
+
+    // Without either, stream the initramfs from the boot partition ourselves instead of going through the firmware.
+    if (!initramfs_entry && !initramfs_ext && find_initramfs_on_disk(&initramfs_file))
+    {
+        initramfs_on_disk   = true;
+        initramfs_len       = initramfs_file.size;
+    }
+
+    // Overlays are appended to the base image; Linux unpacks the concatenation like a single archive.
+    uint32_t ramdisk_len = initramfs_len;
+    for (payload_entry_t *entry = payload_find(PAYLOAD_TYPE_OVERLAY, NULL); entry;
+         entry = payload_find(PAYLOAD_TYPE_OVERLAY, entry))
+    {
+        ramdisk_len = ROUND_UP(ramdisk_len, PAYLOAD_OVERLAY_ALIGN) + entry->size;
+    }
+
     // Check that we are loading a Linux kernel
     uint32_t *signature = (uint32_t *) (kernel_bin + 0x202);
     if (*signature != 'SrdH')
@@ -84,14 +183,32 @@ noreturn void load_linux(void)
     // Find actual length of the kernel
     uint32_t real_kernel_len = kernel_bin_len - ((kernel_bin[0x1f1] + 1) * 512);
 
+    // we should actually copy the initramfs to high memory to avoid kernel oops at free_init_pages()
+    // counterintuitively, this seems to lead to more available RAM once booted.
+    uint32_t ramdisk_loadaddr = gBA->kernel_base + gBA->kernel_size;
+    if (initramfs_entry && initramfs_entry->alignment)
+        ramdisk_loadaddr = ROUND_UP(ramdisk_loadaddr, initramfs_entry->alignment);
+    else
+        ramdisk_loadaddr = ROUND_UP(ramdisk_loadaddr, PAGE_SIZE);
+
+    // boot.efi already put the extension in memory Linux can reclaim, so hand it over where it is if it starts on a
+    // page (see above). We don't know what follows it, so it has to be moved if overlays need appending.
+    if (initramfs_ext && ramdisk_len == initramfs_len && ((uint32_t) initramfs_ext & (PAGE_SIZE - 1)) == 0)
+        ramdisk_loadaddr = (uint32_t) initramfs_ext;
+
     // Determine where a safe place in memory to copy the kernel to is
-    uint32_t kernel_loadaddr = ROUND_UP(gBA->kernel_base + gBA->kernel_size + initramfs_bin_len,
-                                        LINUX_KERNEL_LOAD_INCREMENT);
+    uint32_t kernel_loadaddr = gBA->kernel_base + gBA->kernel_size;
+    if (ramdisk_loadaddr + ramdisk_len > kernel_loadaddr)
+        kernel_loadaddr = ramdisk_loadaddr + ramdisk_len;
+    if (initramfs_ext && (uint32_t) initramfs_ext + initramfs_len > kernel_loadaddr)
+        kernel_loadaddr = (uint32_t) initramfs_ext + initramfs_len;
+    kernel_loadaddr = ROUND_UP(kernel_loadaddr, LINUX_KERNEL_LOAD_INCREMENT);
 
     // Copy kernel to the correct address
     trace("Copying kernel to 0x%X...", kernel_loadaddr);
     memcpy((void *) kernel_loadaddr, &kernel_bin[(kernel_bin[0x1f1] + 1) * 512], real_kernel_len);
     dprintf("done.\n");
+    splash_progress(1, LOAD_STAGES);
 
     // Zero the boot parameters
     memset(&bp, 0, sizeof(struct boot_params));
@@ -111,19 +228,59 @@ noreturn void load_linux(void)
         fail(__FILE__, __LINE__, "zImage kernels are unsupported; please use a bzImage");
     }
 
-    // Configure the initramfs
-    if (initramfs_bin_len)
-    {
-        // we should actually copy the initramfs to high memory to avoid kernel oops at free_init_pages()
-        // counterintuitively, this seems to lead to more available RAM once booted.
-        uint32_t ramdisk_loadaddr = gBA->kernel_base + gBA->kernel_size;
+    // Configure the initramfs. Entries the prune manifest excludes for this model are dropped while it is copied into
+    // place, so pruning doesn't cost an extra pass.
+    boolean_t prune = prune_init((efi_system_table_32_t *) gBA->efi_sys_tbl);
 
+    if (initramfs_entry)
+    {
         trace("Copying initramfs to 0x%X...", ramdisk_loadaddr);
-        memcpy((void *) ramdisk_loadaddr, &initramfs_bin, initramfs_bin_len);
+        if (prune)
+            initramfs_len = prune_initramfs((void *) ramdisk_loadaddr, payload_data(initramfs_entry), initramfs_len);
+        else
+            payload_load(initramfs_entry, (void *) ramdisk_loadaddr);
+        dprintf("done.\n");
+    }
+    else if (initramfs_ext && (ramdisk_loadaddr != (uint32_t) initramfs_ext || prune))
+    {
+        trace("Moving initramfs to 0x%X...", ramdisk_loadaddr);
+        initramfs_len = prune_initramfs((void *) ramdisk_loadaddr, initramfs_ext, initramfs_len);
+        dprintf("done.\n");
+    }
+    else if (initramfs_on_disk)
+    {
+        trace("Reading initramfs from disk to 0x%X...", ramdisk_loadaddr);
+        if (!fat32_read(&initramfs_file, (void *) ramdisk_loadaddr))
+            fail(__FILE__, __LINE__, "Failed to read the initramfs from disk!");
+        if (prune)
+            initramfs_len = prune_initramfs((void *) ramdisk_loadaddr, (void *) ramdisk_loadaddr, initramfs_len);
         dprintf("done.\n");
+    }
+
+    splash_progress(2, LOAD_STAGES);
+
+    // Append the overlays behind the base image, padding each to a 4 byte boundary
+    uint32_t overlay_addr = ramdisk_loadaddr + initramfs_len;
+    for (payload_entry_t *entry = payload_find(PAYLOAD_TYPE_OVERLAY, NULL); entry;
+         entry = payload_find(PAYLOAD_TYPE_OVERLAY, entry))
+    {
+        uint32_t aligned_addr = ROUND_UP(overlay_addr, PAYLOAD_OVERLAY_ALIGN);
+        memset((void *) overlay_addr, 0, aligned_addr - overlay_addr);
+
+        trace("Appending overlay %s at 0x%X...", entry->name, aligned_addr);
+        overlay_addr = aligned_addr + payload_load(entry, (void *) aligned_addr);
+        dprintf("done.\n");
+    }
+
+    // Pruning may have shrunk the base image
+    ramdisk_len = overlay_addr - ramdisk_loadaddr;
 
+    splash_progress(3, LOAD_STAGES);
+
+    if (ramdisk_len)
+    {
         setup_header->ramdisk_image = ramdisk_loadaddr;
-        setup_header->ramdisk_size  = initramfs_bin_len;
+        setup_header->ramdisk_size  = ramdisk_len;
     }
 
     // Configure video
@@ -167,6 +324,28 @@ noreturn void load_linux(void)
                                       gBA->efi_mem_desc_size,
                                       bp.e820_table);
 
+    // Optionally test RAM before Linux gets it, leaving everything we still need alone
+    uint32_t esp;
+    asm("mov %%esp, %0" : "=r"(esp));
+
+    memtest_range_t memtest_skip[] =
+    {
+        { 0,                                0x100000 },                                     // low memory, SMBIOS copy
+        { gBA->kernel_base,                 gBA->kernel_base + gBA->kernel_size },          // us
+        { ramdisk_loadaddr,                 ramdisk_loadaddr + ramdisk_len },
+        { kernel_loadaddr,                  kernel_loadaddr + real_kernel_len },
+        { (uint32_t) gBA,                   (uint32_t) gBA + sizeof(mach_boot_args_t) },    // the command line
+        { esp - 0x10000,                    esp + 0x10000 },                                // the stack, including bp
+    };
+
+    bp.e820_entries = memtest_run(bp.e820_table, bp.e820_entries, memtest_skip,
+                                  sizeof(memtest_skip) / sizeof(memtest_skip[0]));
+
+    splash_progress(LOAD_STAGES, LOAD_STAGES);
+
+    // Let systemd-analyze & co. see how long the loader took
+    bli_export((efi_system_table_32_t *) gBA->efi_sys_tbl);
+
     // We should be good to start the Linux kernel now.
     // Jump to the kernel load address!
     trace("Starting kernel...");
@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - pre-boot memory test
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <linux.h>
+#include <cpu.h>
+#include <timer.h>
+#include <memtest.h>
+
+// All writes are non-temporal, so every read comes from DRAM rather than the cache.
+//
+// Tests:
+//  1. Address in address: each dword holds its own address. All of the memory under test is written before any of it
+//     is checked, so this catches address line faults and aliasing between any two addresses.
+//  2. Moving inversions, per chunk: fill with a pattern, then check and invert it walking up, then check and restore
+//     it walking down. Catches stuck bits and most coupling faults.
+
+#define PAGE_MASK   (PAGE_SIZE - 1)
+
+static const uint32_t   mi_patterns[] = { 0x55555555, 0x00000000, 0x33333333, 0x0F0F0F0F };
+
+static const uint32_t   addr_offsets[4] __attribute__((aligned(16))) = { 0, 4, 8, 12 };
+static const uint32_t   addr_step[4] __attribute__((aligned(16))) = { 16, 16, 16, 16 };
+
+static memtest_range_t  bad_ranges[MEMTEST_MAX_BAD_RANGES];
+static uint32_t         num_bad_ranges;
+static uint32_t         num_bad_pages;
+
+static void mt_fill_addr(uint32_t p, uint32_t end)
+{
+    asm volatile("movd      %[p], %%xmm0\n\t"
+                 "pshufd    $0, %%xmm0, %%xmm0\n\t"
+                 "paddd     %[offsets], %%xmm0\n\t"
+                 "movdqa    %[step], %%xmm1\n"
+                 "1:\n\t"
+                 "movntdq   %%xmm0, (%[p])\n\t"
+                 "paddd     %%xmm1, %%xmm0\n\t"
+                 "add       $16, %[p]\n\t"
+                 "cmp       %[end], %[p]\n\t"
+                 "jb        1b"
+                 : [p] "+r"(p)
+                 : [end] "r"(end), [offsets] "m"(addr_offsets[0]), [step] "m"(addr_step[0])
+                 : "xmm0", "xmm1", "memory", "cc");
+}
+
+// Returns the address of the first bad 16 byte block, or 0 if everything matched.
+static uint32_t mt_check_addr(uint32_t p, uint32_t end)
+{
+    uint32_t mask;
+
+    asm volatile("movd      %[p], %%xmm0\n\t"
+                 "pshufd    $0, %%xmm0, %%xmm0\n\t"
+                 "paddd     %[offsets], %%xmm0\n\t"
+                 "movdqa    %[step], %%xmm1\n"
+                 "1:\n\t"
+                 "movdqa    (%[p]), %%xmm2\n\t"
+                 "pcmpeqd   %%xmm0, %%xmm2\n\t"
+                 "pmovmskb  %%xmm2, %[mask]\n\t"
+                 "cmp       $0xFFFF, %[mask]\n\t"
+                 "jne       2f\n\t"
+                 "paddd     %%xmm1, %%xmm0\n\t"
+                 "add       $16, %[p]\n\t"
+                 "cmp       %[end], %[p]\n\t"
+                 "jb        1b\n\t"
+                 "xor       %[p], %[p]\n"
+                 "2:"
+                 : [p] "+r"(p), [mask] "=&r"(mask)
+                 : [end] "r"(end), [offsets] "m"(addr_offsets[0]), [step] "m"(addr_step[0])
+                 : "xmm0", "xmm1", "xmm2", "memory", "cc");
+
+    return p;
+}
+
+static void mt_fill(uint32_t p, uint32_t end, uint32_t pattern)
+{
+    asm volatile("movd      %[pattern], %%xmm0\n\t"
+                 "pshufd    $0, %%xmm0, %%xmm0\n"
+                 "1:\n\t"
+                 "movntdq   %%xmm0, (%[p])\n\t"
+                 "add       $16, %[p]\n\t"
+                 "cmp       %[end], %[p]\n\t"
+                 "jb        1b"
+                 : [p] "+r"(p)
+                 : [end] "r"(end), [pattern] "r"(pattern)
+                 : "xmm0", "memory", "cc");
+}
+
+// Walk up checking for expect and writing write. Returns the first bad block, or 0.
+static uint32_t mt_invert_up(uint32_t p, uint32_t end, uint32_t expect, uint32_t write)
+{
+    uint32_t mask;
+
+    asm volatile("movd      %[expect], %%xmm0\n\t"
+                 "pshufd    $0, %%xmm0, %%xmm0\n\t"
+                 "movd      %[write], %%xmm1\n\t"
+                 "pshufd    $0, %%xmm1, %%xmm1\n"
+                 "1:\n\t"
+                 "movdqa    (%[p]), %%xmm2\n\t"
+                 "pcmpeqd   %%xmm0, %%xmm2\n\t"
+                 "pmovmskb  %%xmm2, %[mask]\n\t"
+                 "cmp       $0xFFFF, %[mask]\n\t"
+                 "jne       2f\n\t"
+                 "movntdq   %%xmm1, (%[p])\n\t"
+                 "add       $16, %[p]\n\t"
+                 "cmp       %[end], %[p]\n\t"
+                 "jb        1b\n\t"
+                 "xor       %[p], %[p]\n"
+                 "2:"
+                 : [p] "+r"(p), [mask] "=&r"(mask)
+                 : [end] "r"(end), [expect] "m"(expect), [write] "m"(write)
+                 : "xmm0", "xmm1", "xmm2", "memory", "cc");
+
+    return p;
+}
+
+// Walk down from end checking for expect and writing write. Returns the first bad block, or 0.
+static uint32_t mt_invert_down(uint32_t start, uint32_t p, uint32_t expect, uint32_t write)
+{
+    uint32_t mask;
+
+    asm volatile("movd      %[expect], %%xmm0\n\t"
+                 "pshufd    $0, %%xmm0, %%xmm0\n\t"
+                 "movd      %[write], %%xmm1\n\t"
+                 "pshufd    $0, %%xmm1, %%xmm1\n"
+                 "1:\n\t"
+                 "sub       $16, %[p]\n\t"
+                 "movdqa    (%[p]), %%xmm2\n\t"
+                 "pcmpeqd   %%xmm0, %%xmm2\n\t"
+                 "pmovmskb  %%xmm2, %[mask]\n\t"
+                 "cmp       $0xFFFF, %[mask]\n\t"
+                 "jne       2f\n\t"
+                 "movntdq   %%xmm1, (%[p])\n\t"
+                 "cmp       %[start], %[p]\n\t"
+                 "ja        1b\n\t"
+                 "xor       %[p], %[p]\n"
+                 "2:"
+                 : [p] "+r"(p), [mask] "=&r"(mask)
+                 : [start] "r"(start), [expect] "m"(expect), [write] "m"(write)
+                 : "xmm0", "xmm1", "xmm2", "memory", "cc");
+
+    return p;
+}
+
+static void memtest_mark_bad(uint32_t addr)
+{
+    uint32_t page = addr & ~PAGE_MASK;
+
+    for (uint32_t i = 0; i < num_bad_ranges; i++)
+    {
+        if (page >= bad_ranges[i].start && page < bad_ranges[i].end)
+            return;
+
+        if (page == bad_ranges[i].end)
+        {
+            bad_ranges[i].end += PAGE_SIZE;
+            num_bad_pages++;
+            return;
+        }
+    }
+
+    num_bad_pages++;
+
+    if (num_bad_ranges == MEMTEST_MAX_BAD_RANGES)
+    {
+        err("Too many memory errors, not all bad pages can be reported to Linux!\n");
+        return;
+    }
+
+    err("Bad memory at 0x%X!\n", addr);
+
+    bad_ranges[num_bad_ranges].start    = page;
+    bad_ranges[num_bad_ranges].end      = page + PAGE_SIZE;
+    num_bad_ranges++;
+}
+
+// What a walk does with each piece of memory it visits. Returns false to stop the walk.
+typedef boolean_t (*memtest_piece_t)(uint32_t start, uint32_t end);
+
+static uint32_t         num_patterns;
+static uint64_t         deadline;
+static uint32_t         addr_tested;
+static uint32_t         mi_tested;
+static uint32_t         num_pieces;
+static uint64_t         piece_write_ticks[MEMTEST_MAX_PIECES];
+
+// Address in address, first walk: write the piece. Every piece is written before any of them is checked, so an
+// address line fault that aliases one piece onto another is caught as well.
+static boolean_t memtest_fill_addr(uint32_t start, uint32_t end)
+{
+    uint64_t t0 = rdtsc();
+    mt_fill_addr(start, end);
+    sfence();
+
+    if (num_pieces < MEMTEST_MAX_PIECES)
+        piece_write_ticks[num_pieces] = rdtsc() - t0;
+    num_pieces++;
+
+    addr_tested += end - start;
+    return true;
+}
+
+// Address in address, second walk: check the piece and report its bandwidth.
+static boolean_t memtest_check_addr(uint32_t start, uint32_t end)
+{
+    uint32_t bad;
+
+    uint64_t t0 = rdtsc();
+    for (uint32_t p = start; p < end && (bad = mt_check_addr(p, end)); p = (bad | PAGE_MASK) + 1)
+        memtest_mark_bad(bad);
+    uint64_t read_ticks = rdtsc() - t0;
+
+    // Bytes per microsecond is MB/s
+    uint32_t bytes      = end - start;
+    uint32_t read_us    = (uint32_t) timer_ticks_to_us(read_ticks);
+    uint32_t write_us   = 0;
+
+    if (num_pieces < MEMTEST_MAX_PIECES)
+        write_us = (uint32_t) timer_ticks_to_us(piece_write_ticks[num_pieces]);
+    num_pieces++;
+
+    if (write_us && read_us)
+    {
+        trace("memtest: 0x%X-0x%X: write %d MB/s, read %d MB/s\n", start, end, bytes / write_us, bytes / read_us);
+    }
+
+    return true;
+}
+
+// Moving inversions over one chunk. Bad pages are skipped for the rest of the pass they were found in.
+static void memtest_chunk(uint32_t start, uint32_t end)
+{
+    uint32_t bad;
+
+    for (uint32_t i = 0; i < num_patterns; i++)
+    {
+        uint32_t pattern = mi_patterns[i];
+
+        mt_fill(start, end, pattern);
+        sfence();
+
+        for (uint32_t p = start; p < end && (bad = mt_invert_up(p, end, pattern, ~pattern)); p = (bad | PAGE_MASK) + 1)
+            memtest_mark_bad(bad);
+        sfence();
+
+        for (uint32_t e = end; e > start && (bad = mt_invert_down(start, e, ~pattern, pattern)); e = bad & ~PAGE_MASK)
+            memtest_mark_bad(bad);
+        sfence();
+    }
+}
+
+// Moving inversions over the piece, a chunk at a time. Returns false once the time budget runs out.
+static boolean_t memtest_inversions(uint32_t start, uint32_t end)
+{
+    uint32_t chunk_end;
+
+    for (uint32_t p = start; p < end; p = chunk_end)
+    {
+        if (deadline && rdtsc() > deadline)
+            return false;
+
+        chunk_end = (end - p > MEMTEST_CHUNK_SIZE) ? p + MEMTEST_CHUNK_SIZE : end;
+        memtest_chunk(p, chunk_end);
+        mi_tested += chunk_end - p;
+    }
+
+    return true;
+}
+
+// Call test on every piece of E820_RAM below 4 GB that isn't in skip, in address order within each entry. Returns
+// false if test stopped the walk.
+static boolean_t memtest_walk(struct boot_e820_entry *memory_map, uint8_t num_entries, const memtest_range_t *skip,
+                              uint32_t num_skip, memtest_piece_t test)
+{
+    num_pieces = 0;
+
+    for (uint32_t i = 0; i < num_entries; i++)
+    {
+        if (memory_map[i].type != E820_RAM || memory_map[i].addr >= 0x100000000ULL)
+            continue;
+
+        uint64_t entry_end = memory_map[i].addr + memory_map[i].size;
+        uint32_t start  = ((uint32_t) memory_map[i].addr + PAGE_MASK) & ~PAGE_MASK;
+        uint32_t end    = (entry_end > 0xFFFFF000ULL) ? 0xFFFFF000 : ((uint32_t) entry_end & ~PAGE_MASK);
+
+        // Carve out the skipped ranges, lowest first
+        while (start < end)
+        {
+            uint32_t piece_end = end;
+
+            for (uint32_t s = 0; s < num_skip; s++)
+            {
+                uint32_t skip_start = skip[s].start & ~PAGE_MASK;
+                uint32_t skip_end   = (skip[s].end + PAGE_MASK) & ~PAGE_MASK;
+
+                if (skip_end <= start || skip_start >= piece_end)
+                    continue;
+
+                if (skip_start <= start)
+                {
+                    start       = skip_end;
+                    piece_end   = end;
+                    s           = -1; // start over with the new start
+                    continue;
+                }
+
+                piece_end = skip_start;
+            }
+
+            if (start >= end)
+                break;
+
+            if (!test(start, piece_end))
+                return false;
+
+            // Move past the piece and the skipped range that ended it
+            start = piece_end;
+        }
+    }
+
+    return true;
+}
+
+// Test every E820_RAM range except the ones in skip and mark bad pages E820_UNUSABLE.
+// Returns the new number of entries in the memory map.
+uint8_t memtest_run(struct boot_e820_entry *memory_map, uint8_t num_entries, const memtest_range_t *skip,
+                    uint32_t num_skip)
+{
+    char        mode_str[8];
+    uint32_t    mode;
+
+    if (!cmdline_get(MEMTEST_CMDLINE_KEY, mode_str, sizeof(mode_str)))
+        return num_entries;
+
+    if (strcmp(mode_str, "quick") == 0)
+        mode = MEMTEST_QUICK;
+    else if (strcmp(mode_str, "full") == 0)
+        mode = MEMTEST_FULL;
+    else
+        return num_entries;
+
+    if (!cpu_enable_sse2())
+    {
+        warn("memtest: SSE2 isn't available, skipping memory test.\n");
+        return num_entries;
+    }
+
+    num_patterns = (mode == MEMTEST_FULL) ? sizeof(mi_patterns) / sizeof(mi_patterns[0]) : 1;
+    deadline = 0;
+    if (mode == MEMTEST_QUICK)
+        deadline = rdtsc() + (uint64_t) MEMTEST_QUICK_BUDGET_MS * timer_tsc_khz();
+
+    num_bad_ranges  = 0;
+    num_bad_pages   = 0;
+    addr_tested     = 0;
+    mi_tested       = 0;
+
+    trace("Testing memory (%s)...\n", mode_str);
+    uint64_t start_tsc = rdtsc();
+
+    // The address test always covers everything; the budget only cuts the moving inversions short.
+    memtest_walk(memory_map, num_entries, skip, num_skip, memtest_fill_addr);
+    memtest_walk(memory_map, num_entries, skip, num_skip, memtest_check_addr);
+    boolean_t finished = memtest_walk(memory_map, num_entries, skip, num_skip, memtest_inversions);
+
+    trace("memtest: address test over %d MB, moving inversions over %d MB in %d ms%s, %d bad pages.\n",
+          addr_tested >> 20, mi_tested >> 20, timer_us_since(start_tsc) / 1000,
+          finished ? "" : " (time budget exhausted)", num_bad_pages);
+
+    for (uint32_t i = 0; i < num_bad_ranges; i++)
+    {
+        if (!e820_change_type(memory_map, &num_entries, bad_ranges[i].start,
+                              bad_ranges[i].end - bad_ranges[i].start, E820_RAM, E820_UNUSABLE))
+        {
+            err("No room in the memory map to mark 0x%X as unusable!\n", bad_ranges[i].start);
+        }
+    }
+
+    return num_entries;
+}
@@ -0,0 +1,9 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - initramfs overlay container
+ * SPDX-License-Identifier: MIT
+ */
+
+// Overlays are small cpio archives appended to the initramfs at boot. They live in their own translation unit so
+// that changing them only rebuilds this file instead of the container holding the kernel and base initramfs.
+#include "overlay_bin.h"
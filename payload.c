@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - embedded payload container
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <linux.h>
+#include <payload.h>
+
+// Payload container built by tools/mkpayload
+#include "payload_bin.h"
+
+// Initramfs overlays are packed into a container of their own (see overlay.c) so changing them doesn't rebuild the
+// one holding the kernel and base image.
+extern unsigned char    overlay_bin[];
+extern unsigned int     overlay_bin_len;
+
+typedef struct _payload_container_t
+{
+    const char          *name;
+    uint8_t             *data;
+    uint32_t            len;
+    payload_header_t    *header;
+    payload_entry_t     *table;
+} payload_container_t;
+
+static payload_container_t containers[] = {
+    { "payload_bin", payload_bin, 0 },
+    { "overlay_bin", overlay_bin, 0 },
+};
+
+#define NUM_CONTAINERS  (sizeof(containers) / sizeof(containers[0]))
+
+static uint32_t crc_table[256];
+
+// Checksumming an entry's data costs several times more than copying it, so it's only done on request
+static boolean_t verify_data;
+
+// Standard (zlib-compatible) CRC32. The table is built on first use.
+uint32_t crc32(uint32_t crc, const void *buf, uint32_t len)
+{
+    const uint8_t *p = buf;
+
+    if (!crc_table[1])
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            crc_table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    while (len--)
+        crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static void payload_init_container(payload_container_t *container)
+{
+    payload_header_t *header = (payload_header_t *) container->data;
+
+    if (container->len < sizeof(payload_header_t) || header->magic != PAYLOAD_MAGIC)
+        fail(__FILE__, __LINE__, "No payload container found! Was mach_kernel built with tools/mkpayload?");
+
+    if (header->version != PAYLOAD_VERSION || header->entry_size != sizeof(payload_entry_t))
+        fail(__FILE__, __LINE__, "Unsupported payload container version!");
+
+    if (header->total_size > container->len
+        || header->header_size + header->num_entries * header->entry_size > header->total_size)
+        fail(__FILE__, __LINE__, "Payload container is truncated!");
+
+    payload_entry_t *table = (payload_entry_t *) (container->data + header->header_size);
+
+    if (crc32(0, table, header->num_entries * header->entry_size) != header->table_crc32)
+        fail(__FILE__, __LINE__, "Payload container table is corrupted!");
+
+    for (uint32_t i = 0; i < header->num_entries; i++)
+    {
+        if (table[i].offset > header->total_size || table[i].stored_size > header->total_size - table[i].offset)
+            fail(__FILE__, __LINE__, "Payload entry lies outside of the container!");
+
+        // Callers copy size bytes straight out of the container
+        if (table[i].codec == PAYLOAD_CODEC_NONE && table[i].size != table[i].stored_size)
+            fail(__FILE__, __LINE__, "Payload entry size doesn't match its stored size!");
+    }
+
+    container->header   = header;
+    container->table    = table;
+
+    trace("Found %s with %d entries.\n", container->name, header->num_entries);
+}
+
+// Validate the container headers and entry tables. Entry data is only checked once it's actually used, and only if
+// "atv.verify=1" is in the Kernel Flags.
+void payload_init(void)
+{
+    char value[4];
+
+    verify_data = cmdline_get(PAYLOAD_VERIFY_CMDLINE_KEY, value, sizeof(value)) && strcmp(value, "1") == 0;
+
+    containers[0].len = payload_bin_len;
+    containers[1].len = overlay_bin_len;
+
+    for (uint32_t i = 0; i < NUM_CONTAINERS; i++)
+        payload_init_container(&containers[i]);
+}
+
+static payload_container_t *payload_container_of(payload_entry_t *entry)
+{
+    for (uint32_t i = 0; i < NUM_CONTAINERS; i++)
+    {
+        if (entry >= containers[i].table && entry < containers[i].table + containers[i].header->num_entries)
+            return &containers[i];
+    }
+
+    fail(__FILE__, __LINE__, "Payload entry doesn't belong to any container!");
+}
+
+// Return the entry after prev, or the first entry if prev is NULL. Containers are walked in order.
+payload_entry_t *payload_next(payload_entry_t *prev)
+{
+    uint32_t i = 0;
+
+    if (prev)
+    {
+        payload_container_t *container = payload_container_of(prev);
+        if (prev + 1 < container->table + container->header->num_entries)
+            return prev + 1;
+        i = (container - containers) + 1;
+    }
+
+    for (; i < NUM_CONTAINERS; i++)
+    {
+        if (containers[i].header->num_entries)
+            return containers[i].table;
+    }
+
+    return NULL;
+}
+
+// Return the next entry of the given type after prev, or the first one if prev is NULL.
+payload_entry_t *payload_find(uint32_t type, payload_entry_t *prev)
+{
+    payload_entry_t *entry = prev;
+
+    while ((entry = payload_next(entry)))
+    {
+        if (entry->type == type)
+            return entry;
+    }
+
+    return NULL;
+}
+
+// Return a pointer to an entry's data inside the container, verifying it first if requested.
+const uint8_t *payload_data(payload_entry_t *entry)
+{
+    const uint8_t *data = payload_container_of(entry)->data + entry->offset;
+
+    if (entry->codec != PAYLOAD_CODEC_NONE)
+        fail(__FILE__, __LINE__, "Payload entry uses an unsupported codec!");
+
+    if (verify_data && crc32(0, data, entry->stored_size) != entry->crc32)
+        fail(__FILE__, __LINE__, "Payload entry checksum mismatch! mach_kernel is corrupted.");
+
+    return data;
+}
+
+// Copy an entry's decoded contents to dest, verifying it first if requested.
+// Returns the number of bytes written.
+uint32_t payload_load(payload_entry_t *entry, void *dest)
+{
+    if (entry->alignment && ((uint32_t) dest & (entry->alignment - 1)))
+        fail(__FILE__, __LINE__, "Payload load address is misaligned!");
+
+    const uint8_t *data = payload_data(entry);
+
+    memcpy(dest, data, entry->size);
+
+    return entry->size;
+}
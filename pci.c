@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - PCI configuration space access
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <io.h>
+#include <pci.h>
+
+static inline void pci_select(pci_device_t *dev, uint8_t reg)
+{
+    outl(PCI_CONFIG_ADDRESS, 0x80000000 | (dev->bus << 16) | (dev->device << 11) | (dev->function << 8) | (reg & 0xFC));
+}
+
+uint32_t pci_read32(pci_device_t *dev, uint8_t reg)
+{
+    pci_select(dev, reg);
+    return inl(PCI_CONFIG_DATA);
+}
+
+uint16_t pci_read16(pci_device_t *dev, uint8_t reg)
+{
+    pci_select(dev, reg);
+    return inw(PCI_CONFIG_DATA + (reg & 2));
+}
+
+void pci_write16(pci_device_t *dev, uint8_t reg, uint16_t value)
+{
+    pci_select(dev, reg);
+    outw(PCI_CONFIG_DATA + (reg & 2), value);
+}
+
+// Find the index'th function with the given class/subclass.
+// Returns false if there is none.
+boolean_t pci_find_class(uint16_t class, uint32_t index, pci_device_t *dev)
+{
+    for (uint32_t bus = 0; bus < PCI_MAX_BUS; bus++)
+    {
+        for (uint32_t device = 0; device < PCI_MAX_DEVICE; device++)
+        {
+            for (uint32_t function = 0; function < PCI_MAX_FUNCTION; function++)
+            {
+                dev->bus        = bus;
+                dev->device     = device;
+                dev->function   = function;
+
+                if (pci_read16(dev, PCI_VENDOR_ID) == 0xFFFF)
+                {
+                    // No device means no other functions either
+                    if (function == 0)
+                        break;
+                    continue;
+                }
+
+                uint32_t class_rev = pci_read32(dev, PCI_CLASS_REVISION);
+                if ((class_rev >> 16) == class && index-- == 0)
+                {
+                    dev->prog_if = (class_rev >> 8) & 0xFF;
+                    return true;
+                }
+
+                // Only look at the other functions of multi-function devices
+                if (function == 0 && !(pci_read32(dev, PCI_HEADER_TYPE & 0xFC) & (0x80 << 16)))
+                    break;
+            }
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - model-aware initramfs pruning
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <linux.h>
+#include <payload.h>
+#include <smbios.h>
+#include <cpio.h>
+#include <prune.h>
+
+typedef struct _prune_rule_t
+{
+    const char  *pattern;
+    uint32_t    len;
+} prune_rule_t;
+
+static prune_rule_t rules[PRUNE_MAX_RULES];
+static uint32_t     num_rules;
+
+static boolean_t prune_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static boolean_t prune_filter(const char *name, uint32_t mode, void *context)
+{
+    for (uint32_t i = 0; i < num_rules; i++)
+    {
+        if (cpio_match(rules[i].pattern, rules[i].len, name))
+            return true;
+    }
+
+    return false;
+}
+
+// Collect the rules of the prune manifest that apply to this model. Returns false if there is nothing to prune.
+boolean_t prune_init(efi_system_table_32_t *systbl)
+{
+    char model[PRUNE_MODEL_LEN];
+
+    num_rules = 0;
+
+    payload_entry_t *entry = payload_find(PAYLOAD_TYPE_PRUNE, NULL);
+    if (!entry)
+        return false;
+
+    if (!smbios_get_string(systbl, SMBIOS_TYPE_SYSTEM, SMBIOS_SYSTEM_PRODUCT_NAME, model, sizeof(model)))
+    {
+        warn("No SMBIOS product name, only applying prune rules for all models.\n");
+        model[0] = 0;
+    }
+
+    const char *p   = (const char *) payload_data(entry);
+    const char *end = p + entry->size;
+
+    while (p < end)
+    {
+        const char *line_end = p;
+        while (line_end < end && *line_end != '\n')
+            line_end++;
+
+        while (p < line_end && prune_is_space(*p))
+            p++;
+
+        const char *model_start = p;
+        while (p < line_end && !prune_is_space(*p))
+            p++;
+        uint32_t model_len = p - model_start;
+
+        while (p < line_end && prune_is_space(*p))
+            p++;
+
+        const char *pattern = p;
+        while (p < line_end && !prune_is_space(*p))
+            p++;
+        uint32_t pattern_len = p - pattern;
+
+        // Paths in the archive are relative
+        while (pattern_len && *pattern == '/')
+        {
+            pattern++;
+            pattern_len--;
+        }
+        while (pattern_len && pattern[pattern_len - 1] == '/')
+            pattern_len--;
+
+        boolean_t applies = (model_len == 1 && *model_start == '*')
+                            || (model_len && model_len == strlen(model) && !memcmp(model_start, model, model_len));
+
+        if (model_len && *model_start != '#' && pattern_len && applies)
+        {
+            if (num_rules == PRUNE_MAX_RULES)
+            {
+                warn("Too many prune rules, ignoring the rest.\n");
+                break;
+            }
+
+            rules[num_rules].pattern    = pattern;
+            rules[num_rules].len        = pattern_len;
+            num_rules++;
+        }
+
+        p = line_end + 1;
+    }
+
+    trace("%d prune rules apply to %s.\n", num_rules, model[0] ? model : "this model");
+
+    return num_rules != 0;
+}
+
+// Copy the initramfs at src (len bytes) to dst, dropping the entries the prune rules match. Returns the new length.
+uint32_t prune_initramfs(void *dst, const void *src, uint32_t len)
+{
+    cpio_prune_stats_t stats;
+
+    if (!num_rules)
+    {
+        if (dst != src)
+            memmove(dst, src, len);
+        return len;
+    }
+
+    // cpio_prune() reads ahead of where it writes, so a destination overlapping the source from above is moved into
+    // place first and pruned there.
+    if ((uint8_t *) dst > (const uint8_t *) src && (uint8_t *) dst < (const uint8_t *) src + len)
+    {
+        memmove(dst, src, len);
+        src = dst;
+    }
+
+    uint32_t new_len = cpio_prune(dst, src, len, prune_filter, NULL, &stats);
+
+    trace("Pruned %d of %d initramfs entries (%d KB).\n", stats.dropped, stats.dropped + stats.kept,
+          stats.dropped_bytes >> 10);
+
+    return new_len;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Apple TV Linux bootloader - SMBIOS support
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <linux.h>
+#include <smbios.h>
+
+// Find the SMBIOS entry point through the EFI configuration table. Returns NULL if there is none.
+smbios_entry_point_t *smbios_find(efi_system_table_32_t *systbl)
+{
+    smbios_entry_point_t *entry_point = NULL;
+
+    efi_config_table_32_t *config_tables = (efi_config_table_32_t *) systbl->tables;
+
+    for (int i = 0; i < systbl->nr_tables; i++)
+    {
+        if (efi_guidcmp(config_tables[i].guid, SMBIOS_TABLE_GUID) == 0)
+        {
+            entry_point = config_tables[i].table;
+        }
+    }
+
+    if (entry_point && memcmp(entry_point->anchor, SMBIOS_ANCHOR, 4) != 0)
+    {
+        warn("SMBIOS entry point at 0x%X has a bad anchor!\n", (uint32_t) entry_point);
+        return NULL;
+    }
+
+    return entry_point;
+}
+
+// Copy string `field` of the first structure of the given type into buf. Returns false if the structure or the
+// string doesn't exist.
+boolean_t smbios_get_string(efi_system_table_32_t *systbl, uint8_t type, uint8_t field, char *buf, uint32_t len)
+{
+    smbios_entry_point_t *entry_point = smbios_find(systbl);
+
+    if (!entry_point || !len)
+        return false;
+
+    uint8_t *p      = (uint8_t *) entry_point->table_address;
+    uint8_t *end    = p + entry_point->table_length;
+
+    for (uint32_t i = 0; i < entry_point->num_structures && p + sizeof(smbios_header_t) <= end; i++)
+    {
+        smbios_header_t *header = (smbios_header_t *) p;
+        uint8_t         *strings = p + header->length;
+
+        if (header->length < sizeof(smbios_header_t) || strings > end)
+            break;
+
+        if (header->type == type && field < header->length)
+        {
+            uint8_t index = p[field];
+
+            // Strings are numbered from 1; 0 means "not specified"
+            for (char *s = (char *) strings; index && (uint8_t *) s < end && *s; s += strlen(s) + 1)
+            {
+                if (--index == 0)
+                {
+                    strlcpy(buf, s, len);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        if (header->type == SMBIOS_TYPE_END)
+            break;
+
+        // Skip the strings to the double NUL
+        p = strings;
+        while (p + 1 < end && (p[0] || p[1]))
+            p++;
+        p += 2;
+    }
+
+    return false;
+}
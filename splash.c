@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Boot splash and progress bar
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <gfx.h>
+#include <splash.h>
+
+// Splash image built by tools/mksplash
+#include "splash_bin.h"
+
+#define PROGRESS_HEIGHT         6
+#define PROGRESS_BORDER         1
+#define PROGRESS_COLOR          COLOR_WHITE
+#define PROGRESS_TRACK_COLOR    0x40404000
+
+extern linear_framebuffer_t fb;
+
+static boolean_t    shown;
+static uint32_t     bar_x;
+static uint32_t     bar_y;
+static uint32_t     bar_width;
+static uint32_t     bar_filled;
+
+static boolean_t splash_format_matches(void)
+{
+    return fb.depth == SPLASH_DEPTH && fb.red_size == 8 && fb.green_size == 8 && fb.blue_size == 8
+           && fb.red_shift == SPLASH_RED_SHIFT && fb.green_shift == SPLASH_GREEN_SHIFT
+           && fb.blue_shift == SPLASH_BLUE_SHIFT;
+}
+
+// The caller makes sure the image fits on the screen. Runs are filled straight into each row with one fence at the end.
+static void splash_draw_image(uint32_t x, uint32_t y)
+{
+    uint32_t column = 0;
+    uint32_t *row = gfx_pixel_addr(x, y);
+
+    for (uint32_t i = 0; i + 1 < splash_rle_len && row; i += 2)
+    {
+        uint32_t count = splash_rle[i];
+
+        if (count > splash_width - column)
+            count = splash_width - column;
+
+        gfx_fill_span(row + column, count, splash_rle[i + 1]);
+
+        column += count;
+        if (column >= splash_width)
+        {
+            column = 0;
+            row = gfx_pixel_addr(x, ++y);
+        }
+    }
+
+    gfx_flush();
+}
+
+// Draw the splash (if one was built in) and an empty progress bar. Only used on quiet boots.
+void splash_show(void)
+{
+    if (!fb.enabled)
+        return;
+
+    uint32_t image_bottom = fb.height / 2;
+
+    if (splash_rle_len && splash_width <= fb.width && splash_height <= fb.height && splash_format_matches())
+    {
+        // Keep the background color boot.efi was configured with
+        gfx_fill_rect(0, 0, fb.width, fb.height, gfx_get_pixel(0, 0));
+
+        uint32_t x = (fb.width - splash_width) / 2;
+        uint32_t y = (fb.height - splash_height) / 2;
+        splash_draw_image(x, y);
+
+        image_bottom = y + splash_height;
+    }
+
+    bar_width   = fb.width / 3;
+    bar_x       = (fb.width - bar_width) / 2;
+    bar_y       = image_bottom + (fb.height - image_bottom) / 2;
+    bar_filled  = 0;
+
+    gfx_fill_rect(bar_x - PROGRESS_BORDER, bar_y - PROGRESS_BORDER,
+                  bar_width + 2 * PROGRESS_BORDER, PROGRESS_HEIGHT + 2 * PROGRESS_BORDER,
+                  RGBA_TO_NATIVE(fb, PROGRESS_TRACK_COLOR));
+
+    shown = true;
+}
+
+// Advance the progress bar to done/total. Only the newly filled part is drawn.
+void splash_progress(uint32_t done, uint32_t total)
+{
+    if (!shown || !total)
+        return;
+
+    if (done > total)
+        done = total;
+
+    uint32_t filled = (bar_width * done) / total;
+    if (filled <= bar_filled)
+        return;
+
+    gfx_fill_rect(bar_x + bar_filled, bar_y, filled - bar_filled, PROGRESS_HEIGHT, RGBA_TO_NATIVE(fb, PROGRESS_COLOR));
+    bar_filled = filled;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Host test for the Boot Loader Interface variable encoding
+ * SPDX-License-Identifier: MIT
+ */
+
+// Built and run by `make test`. Records what bli_set_variables() hands to SetVariable() and checks it.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <efi.h>
+#include <bli.h>
+
+#define MAX_RECORDS 8
+
+typedef struct _record_t
+{
+    char        name[BLI_MAX_VALUE_LEN];
+    char        value[BLI_MAX_VALUE_LEN];
+    efi_guid_t  vendor;
+    uint32_t    attributes;
+    uint32_t    data_size;
+    int         terminated;     // the data ends in a UTF-16 NUL
+    int         ascii_only;     // every UTF-16 unit is below 0x80
+} record_t;
+
+static record_t     records[MAX_RECORDS];
+static int          num_records;
+static int          failures;
+
+static void narrow(char *dst, const uint16_t *src, uint32_t units)
+{
+    uint32_t i;
+
+    for (i = 0; i < units && i < BLI_MAX_VALUE_LEN - 1 && src[i]; i++)
+        dst[i] = (char) src[i];
+    dst[i] = 0;
+}
+
+static efi_status_t record_set_variable(void *context, uint16_t *name, efi_guid_t *vendor, uint32_t attributes,
+                                        uint32_t data_size, void *data)
+{
+    efi_status_t    *status = context;
+    const uint16_t  *value = data;
+    record_t        *record = &records[num_records++];
+
+    narrow(record->name, name, BLI_MAX_VALUE_LEN);
+    narrow(record->value, value, data_size / 2);
+
+    record->vendor      = *vendor;
+    record->attributes  = attributes;
+    record->data_size   = data_size;
+    record->terminated  = data_size >= 2 && !(data_size & 1) && value[data_size / 2 - 1] == 0;
+    record->ascii_only  = 1;
+    for (uint32_t i = 0; i < data_size / 2; i++)
+    {
+        if (value[i] >= 0x80)
+            record->ascii_only = 0;
+    }
+
+    return *status;
+}
+
+static void check(int condition, const char *what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static void check_variable(int index, const char *name, const char *value)
+{
+    efi_guid_t  guid = LOADER_VARIABLE_GUID;
+    record_t    *record = &records[index];
+    char        what[128];
+
+    snprintf(what, sizeof(what), "variable %d is %s", index, name);
+    check(index < num_records && strcmp(record->name, name) == 0, what);
+
+    snprintf(what, sizeof(what), "%s = \"%s\" (got \"%s\")", name, value, record->value);
+    check(strcmp(record->value, value) == 0, what);
+
+    snprintf(what, sizeof(what), "%s is NUL-terminated UTF-16 of the right size", name);
+    check(record->terminated && record->ascii_only && record->data_size == (strlen(value) + 1) * 2, what);
+
+    snprintf(what, sizeof(what), "%s uses the loader vendor GUID", name);
+    check(efi_guidcmp(record->vendor, guid) == 0, what);
+
+    snprintf(what, sizeof(what), "%s is volatile BS|RT", name);
+    check(record->attributes == (EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS), what);
+}
+
+int main(void)
+{
+    static const uint16_t   vendor[] = { 'A', 'p', 'p', 'l', 'e', 0x00E9, 0 };
+    efi_status_t            status = EFI_SUCCESS;
+    bli_ops_t               ops = { record_set_variable, &status };
+    bli_info_t              info = { 1234567, 2345678, vendor, 0x00010001, 0x0001000A };
+
+    check(bli_set_variables(&ops, &info) == 0, "all variables set");
+    check(num_records == 5, "five variables");
+    check_variable(0, "LoaderTimeInitUSec", "1234567");
+    check_variable(1, "LoaderTimeExecUSec", "2345678");
+    check_variable(2, "LoaderInfo", LOADER_INFO);
+    check_variable(3, "LoaderFirmwareInfo", "Apple? 1.01");
+    check_variable(4, "LoaderFirmwareType", "EFI 1.10");
+
+    // Without a start time and vendor, and with UEFI 2.x firmware
+    num_records         = 0;
+    info.init_usec      = 0;
+    info.fw_vendor      = NULL;
+    info.efi_revision   = 0x00020028;
+    bli_set_variables(&ops, &info);
+    check(num_records == 4, "LoaderTimeInitUSec is skipped without a start time");
+    check_variable(2, "LoaderFirmwareInfo", "Unknown 1.01");
+    check_variable(3, "LoaderFirmwareType", "UEFI 2.40");
+
+    // Failures are counted
+    num_records = 0;
+    status      = 0x80000002; // EFI_INVALID_PARAMETER
+    check(bli_set_variables(&ops, &info) == 4, "failed variables are counted");
+
+    if (failures)
+        return 1;
+
+    printf("bli_test: all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Host test for initramfs pruning
+ * SPDX-License-Identifier: MIT
+ */
+
+// Built and run by `make test`. Prunes a hand-built initramfs with the rules from the README example and checks the
+// result byte for byte, for every placement of the destination cpio_prune() allows.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef _Bool boolean_t;
+#define true                1
+#define false               0
+
+#include <cpio.h>
+
+#define BUF_SIZE            16384
+#define DIR_MODE            0040755
+#define FILE_MODE           0100644
+
+typedef struct _test_entry_t
+{
+    const char  *name;
+    uint32_t    mode;
+    uint32_t    nlink;
+    const char  *data;
+    int         dropped;
+} test_entry_t;
+
+// The README example, with the model column already applied
+static const char *rules[] =
+{
+    "usr/lib/firmware/amdgpu",
+    "usr/lib/modules/*/kernel/drivers/gpu/drm/nouveau",
+    "usr/lib/firmware/iwlwifi-*",
+};
+
+#define NUM_RULES           (sizeof(rules) / sizeof(rules[0]))
+
+static const test_entry_t first_archive[] =
+{
+    { ".",                                                          DIR_MODE,   2, NULL,        0 },
+    { "./usr",                                                      DIR_MODE,   2, NULL,        0 },
+    { "./usr/lib/firmware/amdgpu",                                  DIR_MODE,   2, NULL,        1 },
+    { "./usr/lib/firmware/amdgpu/navi10_gpu_info.bin",              FILE_MODE,  1, "navi10",    1 },
+    { "./usr/lib/firmware/amdgpu.txt",                              FILE_MODE,  1, "not a dir", 0 },
+    // Hard links keep their data with the last link only, so they're never dropped
+    { "./usr/lib/firmware/amdgpu/link.bin",                         FILE_MODE,  2, NULL,        0 },
+    { "./usr/lib/firmware/amdgpu/link2.bin",                        FILE_MODE,  2, "linked",    0 },
+    { "./usr/lib/firmware/iwlwifi-1000-5.ucode",                    FILE_MODE,  1, "iwl",       1 },
+    { "./usr/lib/firmware/iwlwifi",                                 DIR_MODE,   2, NULL,        0 },
+    { "/usr/lib/modules/6.1.0-13-686/kernel/drivers/gpu/drm/nouveau/nouveau.ko",
+                                                                    FILE_MODE,  1, "nouveau",   1 },
+    { "usr/lib/modules/6.1.0-13-686/kernel/drivers/gpu/drm/radeon/radeon.ko",
+                                                                    FILE_MODE,  1, "radeon",    0 },
+    { CPIO_TRAILER,                                                 0,          1, NULL,        0 },
+};
+
+static const test_entry_t second_archive[] =
+{
+    { "usr/lib/firmware/amdgpu/polaris10_mc.bin",                   FILE_MODE,  1, "polaris",   1 },
+    { "etc/hostname",                                               FILE_MODE,  1, "appletv\n", 0 },
+    { CPIO_TRAILER,                                                 0,          1, NULL,        0 },
+};
+
+// A compressed archive behind the uncompressed ones is copied as-is
+static const uint8_t compressed_tail[] = { 0x1F, 0x8B, 0x08, 0x00, 0x30, 0x37, 0x30, 0x37, 0x30, 0x31, 0x00, 0xFF };
+
+static uint8_t  source[BUF_SIZE];
+static uint8_t  expected[BUF_SIZE];
+static uint8_t  work[BUF_SIZE];
+static int      failures;
+
+static void check(int condition, const char *what)
+{
+    if (!condition)
+    {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static uint32_t add_entry(uint8_t *buf, uint32_t len, const test_entry_t *entry, uint32_t ino)
+{
+    uint32_t namesize = strlen(entry->name) + 1;
+    uint32_t filesize = entry->data ? strlen(entry->data) : 0;
+    char     header[CPIO_HEADER_SIZE + 1];
+
+    snprintf(header, sizeof(header), "%s%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X", CPIO_NEWC_MAGIC, ino,
+             entry->mode, 0, 0, entry->nlink, 0, filesize, 0, 0, 0, 0, namesize, 0);
+    memcpy(buf + len, header, CPIO_HEADER_SIZE);
+    len += CPIO_HEADER_SIZE;
+
+    memcpy(buf + len, entry->name, namesize);
+    len = (len + namesize + 3) & ~3;
+
+    if (filesize)
+        memcpy(buf + len, entry->data, filesize);
+    return (len + filesize + 3) & ~3;
+}
+
+// Build the test initramfs into buf, leaving out the dropped entries if pruned is set. Returns its length.
+static uint32_t build(uint8_t *buf, int pruned)
+{
+    uint32_t len = 0;
+
+    memset(buf, 0, BUF_SIZE);
+
+    for (uint32_t i = 0; i < sizeof(first_archive) / sizeof(first_archive[0]); i++)
+    {
+        if (!pruned || !first_archive[i].dropped)
+            len = add_entry(buf, len, &first_archive[i], i);
+    }
+
+    // NUL padding between the archives, as left behind by e.g. dracut's early microcode archive
+    len += 12;
+
+    for (uint32_t i = 0; i < sizeof(second_archive) / sizeof(second_archive[0]); i++)
+    {
+        if (!pruned || !second_archive[i].dropped)
+            len = add_entry(buf, len, &second_archive[i], 100 + i);
+    }
+
+    memcpy(buf + len, compressed_tail, sizeof(compressed_tail));
+    return len + sizeof(compressed_tail);
+}
+
+static boolean_t drop_by_rules(const char *name, uint32_t mode, void *context)
+{
+    int *calls = context;
+
+    (*calls)++;
+
+    for (uint32_t i = 0; i < NUM_RULES; i++)
+    {
+        if (cpio_match(rules[i], strlen(rules[i]), name))
+            return true;
+    }
+
+    return false;
+}
+
+static void check_prune(const char *what, uint8_t *dst, const uint8_t *src, uint32_t len, uint32_t expected_len)
+{
+    cpio_prune_stats_t  stats;
+    int                 calls = 0;
+    char                message[128];
+
+    uint32_t new_len = cpio_prune(dst, src, len, drop_by_rules, &calls, &stats);
+
+    snprintf(message, sizeof(message), "%s: length %u (got %u)", what, expected_len, new_len);
+    check(new_len == expected_len, message);
+
+    snprintf(message, sizeof(message), "%s: contents", what);
+    check(new_len == expected_len && memcmp(dst, expected, expected_len) == 0, message);
+
+    // The trailers and hard links never reach the filter
+    snprintf(message, sizeof(message), "%s: filter calls (got %d)", what, calls);
+    check(calls == 11, message);
+
+    snprintf(message, sizeof(message), "%s: stats (kept %u, dropped %u)", what, stats.kept, stats.dropped);
+    check(stats.kept == 10 && stats.dropped == 5 && stats.dropped_bytes == len - expected_len, message);
+}
+
+static void check_match(const char *pattern, const char *name, boolean_t match)
+{
+    char message[256];
+
+    snprintf(message, sizeof(message), "\"%s\" %s \"%s\"", pattern, match ? "matches" : "doesn't match", name);
+    check(cpio_match(pattern, strlen(pattern), name) == match, message);
+}
+
+int main(void)
+{
+    cpio_prune_stats_t stats;
+    int calls = 0;
+
+    check_match("usr/lib/firmware/amdgpu", "usr/lib/firmware/amdgpu", true);
+    check_match("usr/lib/firmware/amdgpu", "usr/lib/firmware/amdgpu/navi10_gpu_info.bin", true);
+    check_match("usr/lib/firmware/amdgpu", "usr/lib/firmware/amdgpu.txt", false);
+    check_match("usr/lib/firmware/amdgpu", "usr/lib/firmware", false);
+    check_match("usr/lib/modules/*/kernel/drivers/gpu/drm/nouveau",
+                "usr/lib/modules/6.1.0-13-686/kernel/drivers/gpu/drm/nouveau/nouveau.ko", true);
+    check_match("usr/lib/modules/*/kernel/drivers/gpu/drm/nouveau",
+                "usr/lib/modules/6.1.0-13-686/kernel/drivers/gpu/drm/nouveau2", false);
+    check_match("usr/lib/firmware/iwlwifi-*", "usr/lib/firmware/iwlwifi-1000-5.ucode", true);
+    check_match("usr/lib/firmware/iwlwifi-*", "usr/lib/firmware/iwlwifi", false);
+    check_match("usr/*/nouveau.ko", "usr/lib/modules/6.1/nouveau.ko", true);
+    check_match("lib/ld-linux.so.?", "lib/ld-linux.so.2", true);
+    check_match("lib/ld-linux.so.?", "lib/ld-linux.so.", false);
+    check_match("lib/ld-linux.so.?", "lib/ld-linux.so.20", false);
+    check_match("*", "anything/at/all", true);
+    check(cpio_match("etc/hostname trailing junk", 12, "etc/hostname"), "only len characters of the pattern count");
+
+    uint32_t len            = build(source, 0);
+    uint32_t expected_len   = build(expected, 1);
+
+    // Into a separate buffer
+    memset(work, 0xAA, BUF_SIZE);
+    check_prune("separate buffer", work, source, len, expected_len);
+
+    // In place
+    memcpy(work, source, len);
+    check_prune("in place", work, work, len, expected_len);
+
+    // Into a destination overlapping the source from below
+    memcpy(work + 300, source, len);
+    check_prune("destination below", work, work + 300, len, expected_len);
+
+    // Anything that isn't a newc archive is copied untouched
+    memset(work, 0, BUF_SIZE);
+    check(cpio_prune(work, compressed_tail, sizeof(compressed_tail), drop_by_rules, &calls, &stats)
+          == sizeof(compressed_tail) && memcmp(work, compressed_tail, sizeof(compressed_tail)) == 0 && !calls
+          && !stats.kept, "a compressed initramfs is copied as-is");
+
+    if (failures)
+        return 1;
+
+    printf("prune_test: all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: TSC based timekeeping
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atvlib.h>
+#include <io.h>
+#include <cpu.h>
+#include <timer.h>
+
+static uint32_t tsc_khz;
+
+// 64-by-32 bit division. We don't link against libgcc/compiler-rt, so the compiler can't do this for us.
+uint64_t udiv64(uint64_t n, uint32_t d)
+{
+    uint32_t hi = n >> 32;
+    uint32_t lo = (uint32_t) n;
+    uint32_t q_hi = hi / d;
+    uint32_t r = hi % d;
+    uint32_t q_lo;
+
+    asm("divl %4" : "=a"(q_lo), "=d"(r) : "a"(lo), "d"(r), "rm"(d));
+
+    return ((uint64_t) q_hi << 32) | q_lo;
+}
+
+// Measure the TSC frequency against TIMER_CALIBRATE_MS of PIT channel 2.
+void timer_init(void)
+{
+    uint32_t count = PIT_FREQUENCY / (1000 / TIMER_CALIBRATE_MS);
+
+    if (tsc_khz)
+        return;
+
+    // Gate channel 2 on, keep the speaker off
+    outb(PIT_CH2_GATE, (inb(PIT_CH2_GATE) & ~PIT_SPEAKER_ENABLE) | PIT_GATE_ENABLE);
+
+    outb(PIT_COMMAND, PIT_CMD_CH2_MODE0);
+    outb(PIT_CH2_DATA, count & 0xFF);
+    outb(PIT_CH2_DATA, (count >> 8) & 0xFF);
+
+    uint64_t start = rdtsc();
+    while (!(inb(PIT_CH2_GATE) & PIT_CH2_OUT))
+        ;
+    uint64_t end = rdtsc();
+
+    tsc_khz = (uint32_t) (end - start) / TIMER_CALIBRATE_MS;
+    if (!tsc_khz)
+        tsc_khz = 1;
+
+    trace("TSC runs at %d kHz.\n", tsc_khz);
+}
+
+uint32_t timer_tsc_khz(void)
+{
+    timer_init();
+    return tsc_khz;
+}
+
+uint64_t timer_ticks_to_us(uint64_t ticks)
+{
+    return udiv64(ticks * 1000, timer_tsc_khz());
+}
+
+// Microseconds since the given rdtsc() value
+uint32_t timer_us_since(uint64_t start)
+{
+    return (uint32_t) timer_ticks_to_us(rdtsc() - start);
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Host tool that packs Linux payloads into the container embedded in mach_kernel
+ * SPDX-License-Identifier: MIT
+ */
+
+// Usage: mkpayload -o <output> <type>[@alignment]=<file> [...]
+//
+// <type> is one of the names in payload_types below or a raw number, so new payload kinds can be added to a
+// build without teaching this tool about them. Entries are stored in the order given on the command line. An empty
+// container is written if no payloads are given.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/payload.h"
+
+#define MAX_ENTRIES 64
+
+static const struct
+{
+    const char  *name;
+    uint32_t    type;
+    uint32_t    alignment;
+} payload_types[] = {
+    { "kernel",     PAYLOAD_TYPE_KERNEL,    0x100000 },
+    { "initramfs",  PAYLOAD_TYPE_INITRAMFS, 0x1000 },
+    { "overlay",    PAYLOAD_TYPE_OVERLAY,   PAYLOAD_OVERLAY_ALIGN },
+    { "prune",      PAYLOAD_TYPE_PRUNE,     1 },
+};
+
+static uint32_t crc_table[256];
+
+uint32_t crc32(uint32_t crc, const void *buf, uint32_t len)
+{
+    const uint8_t *p = buf;
+
+    if (!crc_table[1])
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            crc_table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    while (len--)
+        crc = crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: mkpayload -o <output> <type>[@alignment]=<file> [...]\n");
+    fprintf(stderr, "types: kernel, initramfs, overlay, prune, or a number\n");
+    exit(1);
+}
+
+static uint8_t *read_file(const char *path, uint32_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size < 0 || size > 0x7FFFFFFF)
+    {
+        fprintf(stderr, "%s: file too large\n", path);
+        exit(1);
+    }
+
+    uint8_t *buf = malloc(size ? size : 1);
+    if (!buf || fread(buf, 1, size, f) != (size_t) size)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    fclose(f);
+
+    *len = (uint32_t) size;
+    return buf;
+}
+
+// Parse "<type>[@alignment]=<file>" into an entry.
+static const char *parse_spec(char *spec, payload_entry_t *entry)
+{
+    char *path = strchr(spec, '=');
+    if (!path)
+        usage();
+    *path++ = '\0';
+
+    char *align = strchr(spec, '@');
+    if (align)
+        *align++ = '\0';
+
+    memset(entry, 0, sizeof(*entry));
+    entry->codec = PAYLOAD_CODEC_NONE;
+
+    size_t i;
+    for (i = 0; i < sizeof(payload_types) / sizeof(payload_types[0]); i++)
+    {
+        if (strcmp(spec, payload_types[i].name) == 0)
+        {
+            entry->type         = payload_types[i].type;
+            entry->alignment    = payload_types[i].alignment;
+            break;
+        }
+    }
+    if (i == sizeof(payload_types) / sizeof(payload_types[0]))
+    {
+        char *end;
+        entry->type = strtoul(spec, &end, 0);
+        if (*end || entry->type == PAYLOAD_TYPE_NONE)
+        {
+            fprintf(stderr, "unknown payload type '%s'\n", spec);
+            exit(1);
+        }
+    }
+
+    if (align)
+    {
+        entry->alignment = strtoul(align, NULL, 0);
+        if (entry->alignment & (entry->alignment - 1))
+        {
+            fprintf(stderr, "alignment %s is not a power of two\n", align);
+            exit(1);
+        }
+    }
+
+    const char *base = strrchr(path, '/');
+    strncpy(entry->name, base ? base + 1 : path, PAYLOAD_NAME_LEN - 1);
+
+    return path;
+}
+
+int main(int argc, char **argv)
+{
+    payload_header_t    header;
+    payload_entry_t     table[MAX_ENTRIES];
+    uint8_t             *data[MAX_ENTRIES];
+    const char          *output = NULL;
+    uint32_t            num_entries = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+            continue;
+        }
+
+        if (num_entries == MAX_ENTRIES)
+        {
+            fprintf(stderr, "too many payloads\n");
+            return 1;
+        }
+
+        uint32_t len;
+        const char *path = parse_spec(argv[i], &table[num_entries]);
+        data[num_entries] = read_file(path, &len);
+        table[num_entries].stored_size = len;
+        num_entries++;
+    }
+
+    if (!output)
+        usage();
+
+    // Lay out the data after the entry table
+    uint32_t offset = sizeof(payload_header_t) + num_entries * sizeof(payload_entry_t);
+    for (uint32_t i = 0; i < num_entries; i++)
+    {
+        offset = (offset + PAYLOAD_DATA_ALIGN - 1) & ~(PAYLOAD_DATA_ALIGN - 1);
+
+        table[i].offset = offset;
+        table[i].size   = table[i].stored_size;
+        table[i].crc32  = crc32(0, data[i], table[i].stored_size);
+
+        offset += table[i].stored_size;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic        = PAYLOAD_MAGIC;
+    header.version      = PAYLOAD_VERSION;
+    header.header_size  = sizeof(payload_header_t);
+    header.entry_size   = sizeof(payload_entry_t);
+    header.num_entries  = num_entries;
+    header.total_size   = offset;
+    header.table_crc32  = crc32(0, table, num_entries * sizeof(payload_entry_t));
+
+    FILE *f = fopen(output, "wb");
+    if (!f)
+    {
+        perror(output);
+        return 1;
+    }
+
+    static const uint8_t zero[PAYLOAD_DATA_ALIGN];
+    uint32_t pos = sizeof(header) + num_entries * sizeof(payload_entry_t);
+
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(table, sizeof(payload_entry_t), num_entries, f);
+    for (uint32_t i = 0; i < num_entries; i++)
+    {
+        fwrite(zero, 1, table[i].offset - pos, f);
+        fwrite(data[i], 1, table[i].stored_size, f);
+        pos = table[i].offset + table[i].stored_size;
+
+        printf("  %-24s type %u, %u bytes at 0x%X\n", table[i].name, table[i].type, table[i].size, table[i].offset);
+    }
+
+    if (fclose(f) != 0)
+    {
+        perror(output);
+        return 1;
+    }
+
+    return 0;
+}
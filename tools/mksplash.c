@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2025 Sylas Hollander.
+ * PURPOSE: Host tool that converts a PPM image into the run-length encoded boot splash
+ * SPDX-License-Identifier: MIT
+ */
+
+// Usage: mksplash [image.ppm] > splash_bin.h
+//
+// The image must be a binary (P6) PPM with a maximum value of 255; most image tools can export one, e.g.
+// `convert logo.png logo.ppm`. Pixels are written as x8r8g8b8, the Apple TV framebuffer's format, so the loader
+// only has to fill runs; it skips the image on other layouts. Without an image an empty splash is written.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+static void die(const char *msg)
+{
+    fprintf(stderr, "mksplash: %s\n", msg);
+    exit(1);
+}
+
+// Read the next number from a PPM header, skipping whitespace and comments
+static unsigned long ppm_number(FILE *f)
+{
+    int c;
+
+    for (;;)
+    {
+        c = fgetc(f);
+        if (c == '#')
+        {
+            while (c != '\n' && c != EOF)
+                c = fgetc(f);
+        }
+        else if (!isspace(c))
+        {
+            break;
+        }
+    }
+
+    if (!isdigit(c))
+        die("malformed PPM header");
+
+    unsigned long value = 0;
+    while (isdigit(c))
+    {
+        value = value * 10 + (c - '0');
+        c = fgetc(f);
+    }
+
+    return value;
+}
+
+static void emit_run(uint32_t count, uint32_t pixel, unsigned long *words)
+{
+    const char *separator = ", ";
+    if (*words == 0)
+        separator = "\n    ";
+    else if (*words % 8 == 0)
+        separator = ",\n    ";
+
+    printf("%s0x%X, 0x%08X", separator, count, pixel);
+    *words += 2;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long width = 0, height = 0, words = 0;
+
+    printf("/* Generated by tools/mksplash. Do not edit. */\n");
+
+    if (argc < 2)
+    {
+        printf("unsigned int splash_width = 0;\n");
+        printf("unsigned int splash_height = 0;\n");
+        printf("unsigned int splash_rle[] = { 0 };\n");
+        printf("unsigned int splash_rle_len = 0;\n");
+        return 0;
+    }
+
+    FILE *f = fopen(argv[1], "rb");
+    if (!f)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (fgetc(f) != 'P' || fgetc(f) != '6')
+        die("only binary (P6) PPM images are supported");
+
+    width   = ppm_number(f);
+    height  = ppm_number(f);
+    if (ppm_number(f) != 255)
+        die("only 8-bit PPM images are supported");
+    if (!width || !height || width > 4096 || height > 4096)
+        die("bad image size");
+
+    printf("unsigned int splash_width = %lu;\n", width);
+    printf("unsigned int splash_height = %lu;\n", height);
+    printf("unsigned int splash_rle[] = {");
+
+    for (unsigned long y = 0; y < height; y++)
+    {
+        uint32_t run_pixel = 0, run_count = 0;
+
+        for (unsigned long x = 0; x < width; x++)
+        {
+            int r = fgetc(f), g = fgetc(f), b = fgetc(f);
+            if (b == EOF)
+                die("image data is truncated");
+
+            uint32_t pixel = ((uint32_t) r << 16) | ((uint32_t) g << 8) | (uint32_t) b;
+
+            if (run_count && pixel != run_pixel)
+            {
+                emit_run(run_count, run_pixel, &words);
+                run_count = 0;
+            }
+
+            run_pixel = pixel;
+            run_count++;
+        }
+
+        emit_run(run_count, run_pixel, &words);
+    }
+
+    printf("\n};\n");
+    printf("unsigned int splash_rle_len = %lu;\n", words);
+
+    fclose(f);
+
+    fprintf(stderr, "mksplash: %lux%lu image, %lu runs\n", width, height, words / 2);
+
+    return 0;
+}